@@ -0,0 +1,802 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+namespace manager{
+
+
+    /*!
+     * \brief A function to find the size class of a block.
+     * \return the index of the highest set bit of the size
+     */
+    static size_t floor_log2(size_t t_size) noexcept {
+        size_t k = 0;
+        while(t_size >>= 1){
+            ++k;
+        }
+        return k;
+    }
+
+
+
+    /*!
+     * \brief A function to find the order of the smallest power of two not less than the size.
+     */
+    static size_t ceil_log2(size_t t_size) noexcept {
+        size_t k = floor_log2(t_size);
+        return (t_size & (t_size - 1)) ? k + 1 : k;
+    }
+
+
+
+    /*!
+     * \brief A function to find the lowest non-empty class in a mask.
+     * \return the index of the lowest set bit of the mask, which must not be zero
+     */
+    static size_t lowest_bit(size_t mask) noexcept {
+#if defined(__GNUC__)
+        return static_cast<size_t>(__builtin_ctzll(mask));
+#else
+        size_t k = 0;
+        while(!(mask & 1)){
+            mask >>= 1;
+            ++k;
+        }
+        return k;
+#endif
+    }
+
+
+
+    size_t Allocator::align_up(size_t t_strt, size_t t_align) noexcept {
+        return (t_strt + t_align - 1) & ~(t_align - 1);
+    }
+
+
+
+    Allocator* Allocator::generate_Allocator(Alloc_ID a_id, Unit un) noexcept(false) {
+        Allocator* ptr;
+        switch(a_id){
+            case Index_ID:
+                ptr = new Index_allocator(un);
+                break;
+
+            case Segregated_ID:
+                ptr = new Segregated_allocator(un);
+                break;
+
+            case Buddy_ID:
+                ptr = new Buddy_allocator(un);
+                break;
+
+            case Bitmap_ID:
+                ptr = new Bitmap_allocator(un);
+                break;
+
+            default:
+                throw std::domain_error("unknown allocator id");
+        }
+        return ptr;
+    }
+
+
+
+    void Allocator::set_policy(Fit_policy* t_policy) noexcept(false) {
+        delete t_policy;
+        throw std::domain_error("the allocation engine has no fit policy");
+    }
+
+
+
+    Index_allocator::Index_allocator(Unit un, Fit_policy* t_policy) :
+            total(0),
+            policy(t_policy ? t_policy : new Best_fit_policy) {
+        insert(un);
+    }
+
+
+
+    void Index_allocator::insert(Unit un) {
+        by_address[un.starter_address] = un.size;
+        by_size.insert(std::make_pair(un.size, un.starter_address));
+        total += un.size;
+    }
+
+
+
+    void Index_allocator::erase(std::map<size_t, size_t>::iterator it) {
+        by_size.erase(std::make_pair(it->second, it->first));
+        total -= it->second;
+        by_address.erase(it);
+    }
+
+
+
+    Unit Index_allocator::allocate(size_t t_size, size_t t_align) {
+        Unit block = policy->choose(by_address, by_size, t_size, t_align);
+        if(!block.size)
+            return {};
+
+        size_t strt = align_up(block.starter_address, t_align);
+        erase(by_address.find(block.starter_address));
+        if(strt > block.starter_address)
+            insert(Unit(block.starter_address, strt - block.starter_address));
+        if(block.starter_address + block.size > strt + t_size)
+            insert(Unit(strt + t_size, block.starter_address + block.size - strt - t_size));
+        return {strt, t_size};
+    }
+
+
+
+    void Index_allocator::release(Unit un) noexcept(false) {
+        auto next = by_address.upper_bound(un.starter_address);
+        if(next != by_address.end() && next->first < un.starter_address + un.size)
+            throw std::invalid_argument("attempt to free memory with end after or at arg");
+        if(next != by_address.begin()){
+            auto prev = std::prev(next);
+            if(prev->first + prev->second > un.starter_address)
+                throw std::invalid_argument("attempt to free memory with start before or at arg");
+        }
+        coalesce(un);
+    }
+
+
+
+    void Index_allocator::coalesce(Unit un) {
+        auto next = by_address.lower_bound(un.starter_address);
+        if(next != by_address.end() && next->first == un.starter_address + un.size){
+            un.size += next->second;
+            erase(next++);
+        }
+        if(next != by_address.begin()){
+            auto prev = std::prev(next);
+            if(prev->first + prev->second == un.starter_address){
+                un.starter_address = prev->first;
+                un.size += prev->second;
+                erase(prev);
+            }
+        }
+        insert(un);
+    }
+
+
+
+    void Index_allocator::extend(Unit un) {
+        coalesce(un);
+    }
+
+
+
+    size_t Index_allocator::largest_free() const {
+        return by_size.empty() ? 0 : by_size.rbegin()->first;
+    }
+
+
+
+    std::vector<Unit> Index_allocator::get_free_blocks() const {
+        std::vector<Unit> blocks;
+        for(auto& block : by_address){
+            blocks.emplace_back(block.first, block.second);
+        }
+        return blocks;
+    }
+
+
+
+    bool Index_allocator::take(Unit un) {
+        auto mark = by_address.find(un.starter_address);
+        if(mark == by_address.end() || mark->second != un.size)
+            return false;
+        erase(mark);
+        return true;
+    }
+
+
+
+    void Index_allocator::set_policy(Fit_policy* t_policy) noexcept(false) {
+        if(!t_policy)
+            throw std::invalid_argument("no fit policy given");
+        delete policy;
+        policy = t_policy;
+    }
+
+
+
+    void Index_allocator::clear() {
+        by_address.clear();
+        by_size.clear();
+        total = 0;
+    }
+
+
+
+    Segregated_allocator::Segregated_allocator(Unit un) : nonempty(0), total(0), first(0), largest(0), stale(false) {
+        cover(un);
+        insert(un);
+    }
+
+
+
+    void Segregated_allocator::cover(Unit un) {
+        size_t lower = un.starter_address - un.starter_address % word_bits;
+        size_t upper = un.starter_address + un.size + 1;  // the end of the block has a bit as well
+        if(!ends.empty()){
+            size_t covered = first + ends[0].size() * word_bits;
+            if(lower >= first && upper <= covered)
+                return;
+            lower = std::min(lower, first);
+            upper = std::max(upper, covered);
+        }
+
+        first = lower;
+        ends.clear();
+        size_t count = (upper - first + word_bits - 1) / word_bits;
+        for(;;){
+            ends.emplace_back(count, 0);
+            if(count == 1)
+                break;
+            count = (count + word_bits - 1) / word_bits;
+        }
+        for(auto& block : by_end){
+            mark_end(block.first, true);
+        }
+    }
+
+
+
+    void Segregated_allocator::mark_end(size_t t_end, bool t_set) {
+        size_t i = t_end - first;
+        for(auto& level : ends){
+            unsigned long long& word = level[i / word_bits];
+            bool was = word != 0;
+            if(t_set){
+                word |= 1ULL << (i % word_bits);
+            } else{
+                word &= ~(1ULL << (i % word_bits));
+            }
+            if((word != 0) == was)
+                return;  // the levels above stay as they are
+            i /= word_bits;
+        }
+    }
+
+
+
+    size_t Segregated_allocator::next_end(size_t t_from) const {
+        if(ends.empty())
+            return 0;
+        size_t i = t_from > first ? t_from - first : 0;
+        size_t level = 0;
+        for(;;){  // up while the rest of the word is empty
+            size_t w = i / word_bits;
+            if(w >= ends[level].size())
+                return 0;
+            unsigned long long rest = ends[level][w] & (~0ULL << (i % word_bits));
+            if(rest){
+                i = w * word_bits + lowest_bit(rest);
+                break;
+            }
+            if(level + 1 == ends.size())
+                return 0;
+            i = w + 1;
+            ++level;
+        }
+        while(level > 0){  // down along the lowest non-empty words
+            --level;
+            i = i * word_bits + lowest_bit(ends[level][i]);
+        }
+        return first + i;
+    }
+
+
+
+    void Segregated_allocator::insert(Unit un) {
+        size_t k = floor_log2(un.size);
+        lists[k].push_front(un);
+        by_start[un.starter_address] = lists[k].begin();
+        by_end[un.starter_address + un.size] = lists[k].begin();
+        mark_end(un.starter_address + un.size, true);
+        nonempty |= size_t(1) << k;
+        total += un.size;
+        largest = std::max(largest, un.size);  // exact unless stale, then it is searched for anyway
+    }
+
+
+
+    void Segregated_allocator::erase(std::list<Unit>::iterator it) {
+        size_t k = floor_log2(it->size);
+        if(it->size >= largest)
+            stale = true;
+        by_start.erase(it->starter_address);
+        by_end.erase(it->starter_address + it->size);
+        mark_end(it->starter_address + it->size, false);
+        total -= it->size;
+        lists[k].erase(it);
+        if(lists[k].empty())
+            nonempty &= ~(size_t(1) << k);
+    }
+
+
+
+    Unit Segregated_allocator::allocate(size_t t_size, size_t t_align) {
+        size_t k = floor_log2(t_size);
+        size_t fit = ceil_log2(t_size + t_align - 1);  // every block of this class fits, whatever its padding
+
+        std::list<Unit>::iterator mark;
+        size_t mask = fit < classes ? nonempty & (~size_t(0) << fit) : 0;
+        if(mask){
+            mark = lists[lowest_bit(mask)].begin();
+        } else{
+            auto fits = [t_size, t_align](Unit un) -> bool {
+                return un.size >= t_size && align_up(un.starter_address, t_align) - un.starter_address <= un.size - t_size;
+            };
+            size_t last = fit < classes ? fit : size_t(classes);
+            for(; k < last; ++k){  // the classes whose blocks may fit
+                mark = std::find_if(lists[k].begin(), lists[k].end(), fits);
+                if(mark != lists[k].end())
+                    break;
+            }
+            if(k == last)
+                return {};
+        }
+
+        Unit block = *mark;
+        size_t strt = align_up(block.starter_address, t_align);
+        erase(mark);
+        if(strt > block.starter_address)
+            insert(Unit(block.starter_address, strt - block.starter_address));
+        if(block.starter_address + block.size > strt + t_size)
+            insert(Unit(strt + t_size, block.starter_address + block.size - strt - t_size));
+        return {strt, t_size};
+    }
+
+
+
+    void Segregated_allocator::release(Unit un) noexcept(false) {
+        cover(un);
+        size_t next = next_end(un.starter_address + 1);  // the first free block which may overlap
+        if(next && by_end.at(next)->starter_address < un.starter_address + un.size)
+            throw std::invalid_argument("attempt to free memory which is already free");
+
+        auto left = by_end.find(un.starter_address);
+        if(left != by_end.end()){
+            auto it = left->second;
+            un.starter_address = it->starter_address;
+            un.size += it->size;
+            erase(it);
+        }
+        auto right = by_start.find(un.starter_address + un.size);
+        if(right != by_start.end()){
+            auto it = right->second;
+            un.size += it->size;
+            erase(it);
+        }
+        insert(un);
+    }
+
+
+
+    void Segregated_allocator::extend(Unit un) {
+        release(un);
+    }
+
+
+
+    size_t Segregated_allocator::largest_free() const {
+        if(!stale)
+            return largest;
+        largest = 0;
+        if(nonempty){
+            for(auto& block : lists[floor_log2(nonempty)]){
+                largest = std::max(largest, block.size);
+            }
+        }
+        stale = false;
+        return largest;
+    }
+
+
+
+    std::vector<Unit> Segregated_allocator::get_free_blocks() const {
+        std::vector<Unit> blocks;
+        for(auto& list : lists){
+            blocks.insert(blocks.end(), list.begin(), list.end());
+        }
+        std::sort(blocks.begin(),
+                  blocks.end(),
+                  [](Unit a, Unit b) -> bool { return a.starter_address < b.starter_address; });
+        return blocks;
+    }
+
+
+
+    bool Segregated_allocator::take(Unit un) {
+        auto mark = by_start.find(un.starter_address);
+        if(mark == by_start.end() || mark->second->size != un.size)
+            return false;
+        erase(mark->second);
+        return true;
+    }
+
+
+
+    void Segregated_allocator::clear() {
+        for(auto& list : lists){
+            list.clear();
+        }
+        by_start.clear();
+        by_end.clear();
+        for(auto& level : ends){
+            std::fill(level.begin(), level.end(), 0);
+        }
+        nonempty = 0;
+        total = 0;
+        largest = 0;
+        stale = false;
+    }
+
+
+
+
+    Buddy_allocator::Buddy_allocator(Unit un) : nonempty(0), total(0) {
+        extend(un);
+    }
+
+
+
+    void Buddy_allocator::insert(size_t t_strt, size_t order) {
+        total += size_t(1) << order;
+        for(; order + 1 < orders; ++order){  // climbing up while the buddy is free
+            size_t buddy = t_strt ^ (size_t(1) << order);
+            auto mark = free_lists[order].find(buddy);
+            if(mark == free_lists[order].end())
+                break;
+            free_lists[order].erase(mark);
+            if(free_lists[order].empty())
+                nonempty &= ~(size_t(1) << order);
+            t_strt = std::min(t_strt, buddy);
+        }
+        free_lists[order].insert(t_strt);
+        nonempty |= size_t(1) << order;
+    }
+
+
+
+    Unit Buddy_allocator::allocate(size_t t_size, size_t t_align) {
+        size_t order = ceil_log2(t_size);
+        size_t search = std::max(order, floor_log2(t_align));  // the lower half kept is aligned as the whole
+        size_t mask = search < orders ? nonempty & (~size_t(0) << search) : 0;
+        if(!mask)
+            return {};
+
+        size_t current = lowest_bit(mask);
+        size_t strt = *free_lists[current].begin();
+        free_lists[current].erase(free_lists[current].begin());
+        if(free_lists[current].empty())
+            nonempty &= ~(size_t(1) << current);
+
+        while(current > order){  // splitting, the upper halves stay free
+            --current;
+            free_lists[current].insert(strt + (size_t(1) << current));
+            nonempty |= size_t(1) << current;
+        }
+        total -= size_t(1) << order;
+        return {strt, t_size};
+    }
+
+
+
+    void Buddy_allocator::release(Unit un) noexcept(false) {
+        size_t order = ceil_log2(un.size);
+        if(un.starter_address & ((size_t(1) << order) - 1))
+            throw std::invalid_argument("attempt to free memory which is not a buddy block");
+        if(free_lists[order].count(un.starter_address))
+            throw std::invalid_argument("attempt to free memory which is already free");
+        for(size_t mask = nonempty & ~((size_t(2) << order) - 1); mask; mask &= mask - 1){  // the free ancestors
+            size_t up = lowest_bit(mask);
+            if(free_lists[up].count(un.starter_address & ~((size_t(1) << up) - 1)))
+                throw std::invalid_argument("attempt to free memory inside a free block");
+        }
+        for(size_t mask = nonempty & ((size_t(1) << order) - 1); mask; mask &= mask - 1){  // the free descendants
+            size_t down = lowest_bit(mask);
+            auto mark = free_lists[down].lower_bound(un.starter_address);
+            if(mark != free_lists[down].end() && *mark < un.starter_address + (size_t(1) << order))
+                throw std::invalid_argument("attempt to free memory holding a free block");
+        }
+        insert(un.starter_address, order);
+    }
+
+
+
+    void Buddy_allocator::extend(Unit un) {
+        size_t strt = un.starter_address;
+        size_t end = un.starter_address + un.size;
+        while(strt < end){  // the biggest aligned block fitting in the rest each time
+            size_t order = floor_log2(end - strt);
+            if(strt)
+                order = std::min(order, lowest_bit(strt));
+            insert(strt, order);
+            strt += size_t(1) << order;
+        }
+    }
+
+
+
+
+    size_t Buddy_allocator::largest_free() const {
+        return nonempty ? size_t(1) << floor_log2(nonempty) : 0;
+    }
+
+
+
+    std::vector<Unit> Buddy_allocator::get_free_blocks() const {
+        std::vector<Unit> blocks;
+        for(size_t order = 0; order < orders; ++order){
+            for(size_t strt : free_lists[order]){
+                blocks.emplace_back(strt, size_t(1) << order);
+            }
+        }
+        std::sort(blocks.begin(),
+                  blocks.end(),
+                  [](Unit a, Unit b) -> bool { return a.starter_address < b.starter_address; });
+        return blocks;
+    }
+
+
+
+    bool Buddy_allocator::take(Unit un) {
+        size_t order = ceil_log2(un.size);
+        if(un.size != size_t(1) << order || !free_lists[order].erase(un.starter_address))
+            return false;
+        if(free_lists[order].empty())
+            nonempty &= ~(size_t(1) << order);
+        total -= un.size;
+        return true;
+    }
+
+
+
+    void Buddy_allocator::clear() {
+        for(auto& list : free_lists){
+            list.clear();
+        }
+        nonempty = 0;
+        total = 0;
+    }
+
+
+
+    Bitmap_allocator::Bitmap_allocator(Unit un) : first(0), hint(0), total(0), leaves(1) {
+        build();
+        extend(un);
+    }
+
+
+
+    /*!
+     * \brief A function to measure the free runs of a word, the bit of a free granule is set.
+     * \param prefix set to the free granules at the start of the word
+     * \param suffix set to the free granules at the end of the word
+     * \param longest set to the longest free run inside the word
+     */
+    static void word_runs(size_t& prefix, size_t& suffix, size_t& longest, unsigned long long word) noexcept {
+        const size_t bits = sizeof(unsigned long long) * 8;
+        prefix = ~word ? lowest_bit(~word) : bits;
+        suffix = ~word ? bits - 1 - floor_log2(~word) : bits;
+        longest = 0;
+        for(; word; word &= word >> 1){  // every step shortens each run by one
+            ++longest;
+        }
+    }
+
+
+
+    void Bitmap_allocator::build() {
+        leaves = 1;
+        while(leaves < words.size()){
+            leaves *= 2;
+        }
+        runs.assign(2 * leaves, Run());
+        refresh(0, words.size());
+    }
+
+
+
+    void Bitmap_allocator::refresh(size_t t_from, size_t t_to) {
+        if(t_from >= t_to)
+            return;
+        for(size_t w = t_from; w < t_to; ++w){
+            Run& run = runs[leaves + w];
+            word_runs(run.prefix, run.suffix, run.longest, words[w]);
+        }
+        size_t lo = (leaves + t_from) / 2;
+        size_t hi = (leaves + t_to - 1) / 2;
+        for(; lo; lo /= 2, hi /= 2){  // the parents of the changed nodes, a level at a time
+            for(size_t i = lo; i <= hi; ++i){
+                const Run& left = runs[2 * i];
+                const Run& right = runs[2 * i + 1];
+                Run& run = runs[i];
+                run.length = left.length + right.length;
+                run.prefix = left.prefix == left.length ? left.length + right.prefix : left.prefix;
+                run.suffix = right.suffix == right.length ? right.length + left.suffix : right.suffix;
+                run.longest = std::max(std::max(left.longest, right.longest), left.suffix + right.prefix);
+            }
+        }
+    }
+
+
+
+    size_t Bitmap_allocator::find(size_t t_from, bool t_free) const {
+        size_t bits = words.size() * word_bits;
+        if(t_from >= bits)
+            return bits;
+
+        unsigned long long flip = t_free ? 0 : ~0ULL;  // the granules looked for become the set bits
+        size_t w = t_from / word_bits;
+        unsigned long long word = (words[w] ^ flip) & (~0ULL << (t_from % word_bits));
+        while(!word){
+            ++w;
+#if defined(__AVX2__)
+            const __m256i ones = _mm256_set1_epi64x(-1);
+            while(w + 4 <= words.size()){  // four words with nothing looked for are skipped at once
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words.data() + w));
+                if(t_free ? !_mm256_testz_si256(block, block) : !_mm256_testc_si256(block, ones))
+                    break;
+                w += 4;
+            }
+#endif
+            if(w >= words.size())
+                return bits;
+            word = words[w] ^ flip;
+        }
+        return w * word_bits + lowest_bit(word);
+    }
+
+
+
+    void Bitmap_allocator::mark(size_t t_from, size_t t_to, bool t_free) {
+        size_t first_word = t_from / word_bits;
+        while(t_from < t_to){
+            size_t w = t_from / word_bits;
+            size_t lo = t_from % word_bits;
+            size_t hi = std::min(t_to - w * word_bits, size_t(word_bits));
+            unsigned long long bits = (hi == word_bits ? ~0ULL : (1ULL << hi) - 1) & (~0ULL << lo);
+            if(t_free)
+                words[w] |= bits;
+            else
+                words[w] &= ~bits;
+            t_from = w * word_bits + hi;
+        }
+        refresh(first_word, (t_to + word_bits - 1) / word_bits);
+    }
+
+
+
+    Unit Bitmap_allocator::allocate(size_t t_size, size_t t_align) {
+        size_t need = (t_size + granule - 1) / granule;
+        size_t step = t_align > granule ? t_align / granule : 1;  // the granules themselves are aligned enough
+        size_t bits = words.size() * word_bits;
+        if(need > runs[1].longest)
+            return {};
+
+        for(size_t strt = find(hint * word_bits, true); strt < bits;){
+            size_t end = find(strt, false);
+            size_t from = align_up(first + strt, step) - first;
+            if(from < end && end - from >= need){
+                mark(from, from + need, false);
+                total -= need * granule;
+                while(hint < words.size() && !words[hint])
+                    ++hint;
+                return {(first + from) * granule, t_size};
+            }
+            strt = find(end, true);
+        }
+        return {};
+    }
+
+
+
+    void Bitmap_allocator::release(Unit un) noexcept(false) {
+        size_t from = un.starter_address / granule;
+        size_t to = from + (un.size + granule - 1) / granule;
+        if(un.starter_address % granule || from < first || to - first > words.size() * word_bits)
+            throw std::invalid_argument("attempt to free memory which is not a granule block");
+        from -= first;
+        to -= first;
+        if(find(from, true) < to)
+            throw std::invalid_argument("attempt to free memory which is already free");
+
+        mark(from, to, true);
+        total += (to - from) * granule;
+        hint = std::min(hint, from / word_bits);
+    }
+
+
+
+    void Bitmap_allocator::extend(Unit un) {
+        size_t from = (un.starter_address + granule - 1) / granule;
+        size_t to = (un.starter_address + un.size) / granule;
+        if(from >= to)
+            return;  // not a single whole granule
+
+        size_t lower = from - from % word_bits;
+        bool shifted = false;  // the words move to other leaves then
+        if(words.empty()){
+            first = lower;
+        } else if(lower < first){
+            words.insert(words.begin(), (first - lower) / word_bits, 0);
+            first = lower;
+            hint = 0;
+            shifted = true;
+        }
+        size_t count = (to - first + word_bits - 1) / word_bits;
+        if(words.size() < count)
+            words.resize(count, 0);
+        if(shifted || words.size() > leaves)
+            build();  // otherwise the leaves past the old words already stand for words in use
+        if(find(from - first, true) < to - first)
+            throw std::invalid_argument("attempt to extend with memory which is already free");
+
+        mark(from - first, to - first, true);
+        total += (to - from) * granule;
+        hint = std::min(hint, (from - first) / word_bits);
+    }
+
+
+
+    size_t Bitmap_allocator::largest_free() const {
+        return runs[1].longest * granule;
+    }
+
+
+
+    std::vector<Unit> Bitmap_allocator::get_free_blocks() const {
+        std::vector<Unit> blocks;
+        size_t bits = words.size() * word_bits;
+        for(size_t strt = find(hint * word_bits, true); strt < bits;){
+            size_t end = find(strt, false);
+            blocks.emplace_back((first + strt) * granule, (end - strt) * granule);
+            strt = find(end, true);
+        }
+        return blocks;
+    }
+
+
+
+    bool Bitmap_allocator::take(Unit un) {
+        size_t bits = words.size() * word_bits;
+        size_t from = un.starter_address / granule;
+        size_t to = from + un.size / granule;
+        if(un.starter_address % granule || un.size % granule || from < first || to - first > bits || from == to)
+            return false;
+        from -= first;
+        to -= first;
+        if(find(from, false) < to)
+            return false;
+        if((from && (words[(from - 1) / word_bits] >> ((from - 1) % word_bits) & 1)) || find(to, false) != to)
+            return false;  // only a whole free run is taken
+
+        mark(from, to, false);
+        total -= un.size;
+        while(hint < words.size() && !words[hint])
+            ++hint;
+        return true;
+    }
+
+
+
+    void Bitmap_allocator::clear() {
+        std::fill(words.begin(), words.end(), 0);
+        hint = words.size();
+        total = 0;
+        build();
+    }
+
+
+}
@@ -52,7 +52,8 @@ namespace manager{
                       << "1 - add program;" << std::endl
                       << "2 - run program;" << std::endl
                       << "3 - add a DivSeg to a program;" << std::endl
-                      << "4 - list programs." << std::endl;
+                      << "4 - list programs;" << std::endl
+                      << "5 - compact the memory." << std::endl;
             std::cout << "Input number: ";
             std::cin >> rc;
             std::cout << std::endl;
@@ -72,6 +73,9 @@ namespace manager{
                 case 4:
                     list_programs();
                     break;
+                case 5:
+                    compact();
+                    break;
                 default:
                     std::cout << "Unexpected input. Try again." << std::endl;
                     rc = 0;
@@ -138,6 +142,19 @@ namespace manager{
 
 
 
+    void App::compact() {
+        try{
+            Compaction report = table->compact();
+            std::cout << "Entities moved: " << report.entities_moved << std::endl
+                      << "Bytes moved: " << report.bytes_moved << std::endl
+                      << "Pause: " << report.pause.count() << " us" << std::endl;
+        } catch(std::exception& ex){
+            std::cerr << "Cannot compact the memory: " << ex.what() << std::endl;
+        }
+    }
+
+
+
     App::~App() {
         for(auto program : programs){
             delete program;
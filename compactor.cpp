@@ -0,0 +1,81 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+
+
+namespace manager{
+
+
+    Compactor::Compactor(Table* t_table,
+            size_t t_bytes,
+            std::chrono::microseconds t_pause,
+            std::chrono::milliseconds t_interval) : table(t_table),
+                                                    step_bytes(t_bytes),
+                                                    step_pause(t_pause),
+                                                    interval(t_interval),
+                                                    running(false) {}
+
+
+
+    void Compactor::start() noexcept(false) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if(running)
+            throw std::logic_error("the compactor is already running");
+        if(worker.joinable())
+            worker.join();  // the worker has stopped by itself
+        running = true;
+        worker = std::thread(&Compactor::work, this);
+    }
+
+
+
+    void Compactor::stop() {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            running = false;
+        }
+        wake.notify_all();
+        if(worker.joinable())
+            worker.join();
+    }
+
+
+
+    void Compactor::work() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while(running){
+            lock.unlock();
+            Compaction report;
+            try{
+                report = table->compact_step(step_bytes, step_pause);
+            } catch(std::exception& ex){
+                std::cerr << "Compactor: " << ex.what() << std::endl;
+                lock.lock();
+                running = false;
+                return;
+            }
+            lock.lock();
+            total.bytes_moved += report.bytes_moved;
+            total.entities_moved += report.entities_moved;
+            total.pause += report.pause;
+            wake.wait_for(lock, interval, [this]() { return !running; });
+        }
+    }
+
+
+
+    Compaction Compactor::get_total() const {
+        std::unique_lock<std::mutex> lock(mtx);
+        return total;
+    }
+
+
+
+    Compactor::~Compactor() {
+        stop();
+    }
+
+
+}
@@ -0,0 +1,113 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+
+
+namespace manager{
+
+
+    bool Fit_policy::fits(size_t t_strt, size_t t_block, size_t t_size, size_t t_align) noexcept {
+        return t_block >= t_size && Allocator::align_up(t_strt, t_align) - t_strt <= t_block - t_size;
+    }
+
+
+
+    Fit_policy* Fit_policy::generate_Fit_policy(Fit_ID f_id) noexcept(false) {
+        Fit_policy* ptr;
+        switch(f_id){
+            case Best_fit:
+                ptr = new Best_fit_policy;
+                break;
+
+            case First_fit:
+                ptr = new First_fit_policy;
+                break;
+
+            case Next_fit:
+                ptr = new Next_fit_policy;
+                break;
+
+            case Worst_fit:
+                ptr = new Worst_fit_policy;
+                break;
+
+            default:
+                throw std::domain_error("unknown fit policy id");
+        }
+        return ptr;
+    }
+
+
+
+    Unit Best_fit_policy::choose(const std::map<size_t, size_t>& /*by_address*/,
+            const std::set<std::pair<size_t, size_t>>& by_size,
+            size_t t_size,
+            size_t t_align) {
+        auto mark = by_size.lower_bound(std::make_pair(t_size, size_t(0)));
+        while(mark != by_size.end() && !fits(mark->second, mark->first, t_size, t_align))
+            ++mark;  // the padding does not leave enough space
+        if(mark == by_size.end())
+            return {};
+        return {mark->second, mark->first};
+    }
+
+
+
+    Unit First_fit_policy::choose(const std::map<size_t, size_t>& by_address,
+            const std::set<std::pair<size_t, size_t>>& by_size,
+            size_t t_size,
+            size_t t_align) {
+        if(by_size.empty() || by_size.rbegin()->first < t_size)
+            return {};  // no block is big enough, the walk is spared
+        for(auto& block : by_address){
+            if(fits(block.first, block.second, t_size, t_align))
+                return {block.first, block.second};
+        }
+        return {};
+    }
+
+
+
+    Unit Next_fit_policy::choose(const std::map<size_t, size_t>& by_address,
+            const std::set<std::pair<size_t, size_t>>& by_size,
+            size_t t_size,
+            size_t t_align) {
+        if(by_size.empty() || by_size.rbegin()->first < t_size)
+            return {};
+
+        auto start = by_address.upper_bound(rover);
+        if(start != by_address.begin() && std::prev(start)->first + std::prev(start)->second > rover)
+            --start;  // the block the rover points into
+        auto mark = start;
+        do{
+            if(mark == by_address.end()){  // wrapping around
+                mark = by_address.begin();
+                if(mark == start)
+                    break;
+            }
+            if(fits(mark->first, mark->second, t_size, t_align)){
+                rover = Allocator::align_up(mark->first, t_align) + t_size;
+                return {mark->first, mark->second};
+            }
+            ++mark;
+        } while(mark != start);
+        return {};
+    }
+
+
+
+    Unit Worst_fit_policy::choose(const std::map<size_t, size_t>& /*by_address*/,
+            const std::set<std::pair<size_t, size_t>>& by_size,
+            size_t t_size,
+            size_t t_align) {
+        for(auto mark = by_size.rbegin(); mark != by_size.rend() && mark->first >= t_size; ++mark){
+            if(fits(mark->second, mark->first, t_size, t_align))  // the biggest one unless the padding is in the way
+                return {mark->second, mark->first};
+        }
+        return {};
+    }
+
+
+}
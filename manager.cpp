@@ -3,11 +3,307 @@
 //
 
 #include "manager.h"
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
 
 
 namespace manager{
 
 
+    /*!
+     * \brief A function to read an element stored in the given order.
+     * \param src the first byte of the element
+     * \param size the size of the element
+     * \param order the order the element is stored in
+     * \note The usual widths are read by the Codec, the odd ones byte by byte.
+     */
+    static unsigned long long decode(const unsigned char* src, size_t size, Byte_order order) noexcept {
+        switch(size){
+            case 1:
+                return Codec<uint8_t>::decode(src, order);
+            case 2:
+                return Codec<uint16_t>::decode(src, order);
+            case 4:
+                return Codec<uint32_t>::decode(src, order);
+            case 8:
+                return Codec<uint64_t>::decode(src, order);
+            default:
+                break;
+        }
+        unsigned long long v = 0;
+        if(order == Native_order){  // the lowest bytes of the host number
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            std::memcpy(reinterpret_cast<unsigned char*>(&v) + sizeof(v) - size, src, size);
+#else
+            std::memcpy(&v, src, size);
+#endif
+            return v;
+        }
+        for(size_t i = 0; i < size; ++i){
+            v = (v << 8) | src[i];
+        }
+        return v;
+    }
+
+
+
+    /*!
+     * \brief A function to store an element in the given order.
+     * \param dst the first byte of the element
+     * \param size the size of the element
+     * \param what the element, only its lowest size bytes are stored
+     * \param order the order the element is to be stored in
+     * \note The usual widths are written by the Codec, the odd ones byte by byte.
+     */
+    static void encode(unsigned char* dst, size_t size, unsigned long long what, Byte_order order) noexcept {
+        switch(size){
+            case 1:
+                return Codec<uint8_t>::encode(dst, static_cast<uint8_t>(what), order);
+            case 2:
+                return Codec<uint16_t>::encode(dst, static_cast<uint16_t>(what), order);
+            case 4:
+                return Codec<uint32_t>::encode(dst, static_cast<uint32_t>(what), order);
+            case 8:
+                return Codec<uint64_t>::encode(dst, static_cast<uint64_t>(what), order);
+            default:
+                break;
+        }
+        if(order == Native_order){  // the lowest bytes of the host number
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            std::memcpy(dst, reinterpret_cast<unsigned char*>(&what) + sizeof(what) - size, size);
+#else
+            std::memcpy(dst, &what, size);
+#endif
+            return;
+        }
+        for(size_t i = size; i > 0; --i){
+            dst[i - 1] = static_cast<unsigned char>(what);
+            what >>= 8;
+        }
+    }
+
+
+
+#if defined(__SSSE3__)
+    /*!
+     * \brief A function to build the byte shuffles between packed elements and 8-byte numbers.
+     * \param size the size of the element, 2, 4 or 8
+     * \param swap whether the bytes of the elements are reversed
+     * \param widen true to spread the elements into numbers, false to pack the numbers into elements
+     * \param masks the shuffles, one per pair of numbers in 16 bytes of elements
+     */
+    static void shuffle_masks(size_t size, bool swap, bool widen, __m128i* masks) noexcept {
+        alignas(16) unsigned char bytes[16];
+        for(size_t v = 0; v < 8/size; ++v){
+            for(size_t j = 0; j < 16; ++j){
+                size_t e = widen ? v*2 + j/8 : j/size;  // the element the byte belongs to
+                size_t b = widen ? j%8 : j%size;        // the place of the byte in the number
+                bool used = widen ? b < size : e/2 == v;
+                size_t from = swap ? size - 1 - b : b;
+                bytes[j] = !used ? 0x80 : static_cast<unsigned char>(widen ? e*size + from : (e%2)*8 + from);
+            }
+            masks[v] = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+        }
+    }
+#endif
+
+
+
+    /*!
+     * \brief A function to read a run of elements stored in the given order.
+     * \param src the first byte of the first element
+     * \param size the size of an element
+     * \param count the amount of elements
+     * \param dst the numbers to read the elements to
+     * \param order the order the elements are stored in
+     * \note The widths of 2, 4 and 8 bytes are shuffled 16 bytes at a time when SSSE3 is enabled.
+     */
+    static void decode_range(const unsigned char* src,
+            size_t size,
+            size_t count,
+            unsigned long long* dst,
+            Byte_order order) noexcept {
+        size_t i = 0;
+#if defined(__SSSE3__)
+        if(size == 2 || size == 4 || size == 8){
+            __m128i masks[4];
+            size_t step = 16/size;  // the elements in 16 bytes
+            shuffle_masks(size, swapped(order), true, masks);
+            for(; i + step <= count; i += step){
+                __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i*size));
+                for(size_t v = 0; v < step/2; ++v){
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + v*2), _mm_shuffle_epi8(in, masks[v]));
+                }
+            }
+        }
+#endif
+        for(; i < count; ++i){
+            dst[i] = decode(src + i*size, size, order);
+        }
+    }
+
+
+
+    /*!
+     * \brief A function to store a run of elements in the given order.
+     * \param dst the first byte of the first element
+     * \param size the size of an element
+     * \param count the amount of elements
+     * \param src the numbers to be stored, only their lowest size bytes are stored
+     * \param order the order the elements are to be stored in
+     * \note The widths of 2, 4 and 8 bytes are shuffled 16 bytes at a time when SSSE3 is enabled.
+     */
+    static void encode_range(unsigned char* dst,
+            size_t size,
+            size_t count,
+            const unsigned long long* src,
+            Byte_order order) noexcept {
+        size_t i = 0;
+#if defined(__SSSE3__)
+        if(size == 2 || size == 4 || size == 8){
+            __m128i masks[4];
+            size_t step = 16/size;
+            shuffle_masks(size, swapped(order), false, masks);
+            for(; i + step <= count; i += step){
+                __m128i out = _mm_setzero_si128();
+                for(size_t v = 0; v < step/2; ++v){
+                    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + v*2));
+                    out = _mm_or_si128(out, _mm_shuffle_epi8(in, masks[v]));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*size), out);
+            }
+        }
+#endif
+        for(; i < count; ++i){
+            encode(dst + i*size, size, src[i], order);
+        }
+    }
+
+
+
+    /*!
+     * \brief A function to compute the result of a read-modify-write operation.
+     * \param op the operation
+     * \param v the element
+     * \param what the operand
+     */
+    template<typename T>
+    static T apply(Atomic_op op, T v, T what) noexcept {
+        switch(op){
+            case Add_op:
+                return v + what;
+            case Sub_op:
+                return v - what;
+            case And_op:
+                return v & what;
+            case Or_op:
+                return v | what;
+            case Xor_op:
+                return v ^ what;
+            default:
+                return what;
+        }
+    }
+
+
+
+    /*!
+     * \brief A function to apply a read-modify-write operation with the hardware atomics.
+     * \param src the first byte of the element, aligned to its size
+     * \param op the operation
+     * \param what the operand
+     * \param order the order the element is stored in
+     * \return the element before the operation
+     * \note The swapped elements are only added to or subtracted from in a compare and swap loop,
+     * the other operations work on the swapped operand directly.
+     */
+    template<typename T>
+    static unsigned long long atomic_apply(unsigned char* src,
+            Atomic_op op,
+            unsigned long long t_what,
+            Byte_order order) noexcept {
+#if defined(__GNUC__)
+        T* ptr = reinterpret_cast<T*>(src);
+        T what = static_cast<T>(t_what);
+        bool swap = swapped(order);
+        T raw = swap ? byte_swap(what) : what;
+        T old;
+        switch(op){
+            case Exchange_op:
+                old = __atomic_exchange_n(ptr, raw, __ATOMIC_SEQ_CST);
+                break;
+            case And_op:
+                old = __atomic_fetch_and(ptr, raw, __ATOMIC_SEQ_CST);
+                break;
+            case Or_op:
+                old = __atomic_fetch_or(ptr, raw, __ATOMIC_SEQ_CST);
+                break;
+            case Xor_op:
+                old = __atomic_fetch_xor(ptr, raw, __ATOMIC_SEQ_CST);
+                break;
+            default:
+                if(!swap)
+                    return op == Add_op ? __atomic_fetch_add(ptr, what, __ATOMIC_SEQ_CST)
+                                        : __atomic_fetch_sub(ptr, what, __ATOMIC_SEQ_CST);
+                old = __atomic_load_n(ptr, __ATOMIC_RELAXED);
+                while(!__atomic_compare_exchange_n(ptr, &old, byte_swap(apply(op, byte_swap(old), what)),
+                                                   true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)){}
+                break;
+        }
+        return swap ? byte_swap(old) : old;
+#else
+        return 0;  // never called, atomic_element() finds no elements then
+#endif
+    }
+
+
+
+    /*!
+     * \brief A function to read an element with the hardware atomics.
+     * \param src the first byte of the element, aligned to its size
+     * \param order the order the element is stored in
+     * \return the element
+     */
+    template<typename T>
+    static unsigned long long atomic_load(const unsigned char* src, Byte_order order) noexcept {
+#if defined(__GNUC__)
+        T raw = __atomic_load_n(reinterpret_cast<const T*>(src), __ATOMIC_SEQ_CST);
+        return swapped(order) ? byte_swap(raw) : raw;
+#else
+        return 0;  // never called, atomic_width() finds no elements then
+#endif
+    }
+
+
+
+    /*!
+     * \brief A function to replace an element with the hardware atomics if it holds the expected value.
+     * \param src the first byte of the element, aligned to its size
+     * \param expected the value expected, set to the actual element if it differs
+     * \param desired the value to be set
+     * \param order the order the element is stored in
+     */
+    template<typename T>
+    static bool atomic_compare_exchange(unsigned char* src,
+            unsigned long long& expected,
+            unsigned long long desired,
+            Byte_order order) noexcept {
+#if defined(__GNUC__)
+        bool swap = swapped(order);
+        T raw = swap ? byte_swap(static_cast<T>(expected)) : static_cast<T>(expected);
+        T value = swap ? byte_swap(static_cast<T>(desired)) : static_cast<T>(desired);
+        bool done = __atomic_compare_exchange_n(reinterpret_cast<T*>(src), &raw, value,
+                                                false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+        expected = swap ? byte_swap(raw) : raw;
+        return done;
+#else
+        return false;
+#endif
+    }
+
+
+
     Entity* Entity::generate_Entity(Entity_ID e_id,
             size_t single_size,
             const std::string& t_name) noexcept(false) {
@@ -67,27 +363,15 @@ namespace manager{
 
 
     unsigned long long Value::get_instance(const Table& table) const {
-        unsigned long long v = 0;
-        auto rc = table.read_bytes(position.starter_address, position.size);
-        for(size_t i = 0; i < get_size(); ++i){
-            v = v | (rc[i] << ((get_size() - 1)*8 - i*8));
-        }
-        return v;
+        View rc = table.view(position.starter_address, position.size);
+        return decode(rc.data, rc.size, table.get_order());
     }
 
 
 
     void Value::set_instance(Table& table, unsigned long long new_inst) noexcept(false) {
-        size_t size = get_size();
-        unsigned char c[size];
-        auto p = reinterpret_cast<unsigned char *>(&new_inst);
-        for(size_t i = 0; i < size; ++i){
-            c[size - 1 - i] = p[i];
-        }
-        std::vector<unsigned char>::iterator i1(c);
-        std::vector<unsigned char>::iterator i2 = i1 + size;
-        std::vector<unsigned char> v(i1, i2);
-        table.write(position.starter_address, position.size, v);
+        Mutable_view rc = table.mutable_view(position.starter_address, position.size);
+        encode(rc.data, rc.size, new_inst, table.get_order());
     }
 
 
@@ -292,37 +576,22 @@ namespace manager{
     void Array::set_single_instance(Table& table, size_t where, unsigned long long what) noexcept(false) {
         if(where >= position.size/single_size)
             throw std::runtime_error("There is no such element in the array!");
-        size_t k = static_cast<unsigned long long>(std::pow(2, single_size*8));
-        if(what > k)
+        if(single_size < sizeof(unsigned long long) && (what >> (single_size*8)))
             throw std::runtime_error("The argument is too high to contain!");
 
-        size_t size = single_size;
-        unsigned char c[size];
-        auto p = reinterpret_cast<unsigned char *>(&what);
-        for(size_t i = 0; i < size; ++i){
-            c[size - 1 - i] = p[i];
-        }
-        std::vector<unsigned char>::iterator i1(c);
-        std::vector<unsigned char>::iterator i2 = i1 + size;
-        std::vector<unsigned char> v(i1, i2);
-        table.write(position.starter_address + (size*where), single_size, v);
+        Mutable_view rc = table.mutable_view(position.starter_address + (single_size*where), single_size);
+        encode(rc.data, single_size, what, table.get_order());
     }
 
 
 
 
     unsigned long long Array::get_single_instance(const Table& table, size_t t_index) const noexcept(false) {
-        if(t_index > this->position.size / single_size)
+        if(t_index >= this->position.size / single_size)
             throw std::runtime_error("Unexpected index to read!");
 
-        size_t size = single_size;
-        unsigned long long v = 0;
-        auto rc = table.read_bytes(position.starter_address + (t_index*size), size);
-
-        for(size_t i = 0; i < size; ++i){
-            v = v | (rc[i] << ((size - 1)*8 - i*8));
-        }
-        return v;
+        View rc = table.view(position.starter_address + (t_index*single_size), single_size);
+        return decode(rc.data, single_size, table.get_order());
     }
 
 
@@ -331,19 +600,87 @@ namespace manager{
             size_t t_begin,
             size_t t_end) noexcept(false) {
 
-        if(t_begin > (this->position.size)/single_size)
+        if(t_begin > t_end)
             throw std::invalid_argument("Incorrect first index");
-        if(t_end > (this->position.size)/single_size)
+        if(t_end >= (this->position.size)/single_size)
             throw std::invalid_argument("Incorrect second index");
-        std::vector<unsigned long long> vec;
-        for(size_t i = t_begin; i <= t_end; ++i){
-            vec.push_back(get_single_instance(table, i));
-        }
+        std::vector<unsigned long long> vec(t_end - t_begin + 1);
+        Array::read_range(table, t_begin, vec.size(), vec.data());
         return vec;
     }
 
 
 
+    void Array::read_range(const Table& table,
+            size_t t_begin,
+            size_t t_count,
+            unsigned long long* t_out) const noexcept(false) {
+
+        if(t_count == 0)
+            return;
+        if(t_begin > position.size/single_size || t_count > position.size/single_size - t_begin)
+            throw std::out_of_range("The range exceeds the array!");
+        View rc = table.view(position.starter_address + (t_begin*single_size), t_count*single_size);
+        decode_range(rc.data, single_size, t_count, t_out, table.get_order());
+    }
+
+
+
+    void Array::write_range(Table& table,
+            size_t t_begin,
+            const unsigned long long* t_in,
+            size_t t_count) noexcept(false) {
+
+        if(t_count == 0)
+            return;
+        if(t_begin > position.size/single_size || t_count > position.size/single_size - t_begin)
+            throw std::out_of_range("The range exceeds the array!");
+        if(single_size < sizeof(unsigned long long)){
+            unsigned long long bits = 0;  // nothing is written unless every element fits
+            for(size_t i = 0; i < t_count; ++i){
+                bits |= t_in[i];
+            }
+            if(bits >> (single_size*8))
+                throw std::runtime_error("The argument is too high to contain!");
+        }
+        Mutable_view rc = table.mutable_view(position.starter_address + (t_begin*single_size), t_count*single_size);
+        encode_range(rc.data, single_size, t_count, t_in, table.get_order());
+    }
+
+
+
+    void Array::fill(Table& table, unsigned long long what) noexcept(false) {
+        if(single_size < sizeof(unsigned long long) && (what >> (single_size*8)))
+            throw std::runtime_error("The argument is too high to contain!");
+        std::vector<unsigned char> pattern(single_size);
+        encode(pattern.data(), single_size, what, table.get_order());
+        table.fill(position, pattern);
+    }
+
+
+
+    void Array::copy_from(Table& table, const Array& src) noexcept(false) {
+        if(src.single_size != single_size)
+            throw std::domain_error("the elements are of another size");
+        if(src.position.size > position.size)
+            throw std::out_of_range("The source does not fit in the array!");
+        if(src.position == position)  // a Link to the same block
+            return;
+        table.copy(src.position, position);
+    }
+
+
+
+    void Array::move_elements(Table& table, size_t t_from, size_t t_to, size_t t_count) noexcept(false) {
+        size_t length = position.size/single_size;
+        if(t_from > length || t_count > length - t_from || t_to > length || t_count > length - t_to)
+            throw std::out_of_range("The range exceeds the array!");
+        table.move(Unit(position.starter_address + t_from*single_size, t_count*single_size),
+                   Unit(position.starter_address + t_to*single_size, t_count*single_size));
+    }
+
+
+
     Entity* Array::clone() const {
         auto arr = new Array(*this);
         return arr;
@@ -446,7 +783,7 @@ namespace manager{
 
 
 
-    DivSeg::DivSeg(const DivSeg& ds) : Array(ds) {
+    DivSeg::DivSeg(const DivSeg& ds) : Array(ds), version(0), optimistic(ds.optimistic.load()), watchers(0), rmw_started(0), rmw_done(0) {
         for(const auto& program : ds.programs){
             this->programs.push_back(program);
         }
@@ -454,7 +791,7 @@ namespace manager{
 
 
 
-    DivSeg::DivSeg(DivSeg&& ds) noexcept {
+    DivSeg::DivSeg(DivSeg&& ds) noexcept : version(0), optimistic(ds.optimistic.load()), watchers(0), rmw_started(0), rmw_done(0) {
         this->e_id = ds.e_id;
         this->name = ds.name;
         this->position = ds.position;
@@ -563,21 +900,390 @@ namespace manager{
 
 
 
+    void DivSeg::lock() {
+        mtx.lock();
+        version.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);  // the odd version is seen before the new data
+    }
+
+
+
+    void DivSeg::unlock() {
+        version.fetch_add(1, std::memory_order_release);
+        mtx.unlock();
+        notify();
+    }
+
+
+
+    void DivSeg::notify() {
+        if(!watchers)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(watch_mtx);  // a waiter is either asleep or yet to read the element
+        }
+        changed.notify_all();
+    }
+
+
+
+    bool DivSeg::watch(Table& table,
+            size_t where,
+            const std::function<bool(unsigned long long)>& pred,
+            bool timed,
+            std::chrono::steady_clock::time_point deadline,
+            unsigned long long& value) noexcept(false) {
+
+        std::unique_lock<std::mutex> lock(watch_mtx);
+        ++watchers;
+        try{
+            for(;;){
+                value = get_single_instance(table, where);
+                if(pred(value))
+                    break;
+                if(!timed){
+                    changed.wait(lock);
+                } else if(changed.wait_until(lock, deadline) == std::cv_status::timeout){
+                    value = get_single_instance(table, where);
+                    break;
+                }
+            }
+        }
+        catch(...){
+            --watchers;
+            throw;
+        }
+        --watchers;
+        return pred(value);
+    }
+
+
+
+    bool DivSeg::wait_until_changed(Table& table,
+            size_t where,
+            unsigned long long expected,
+            std::chrono::microseconds t_wait) noexcept(false) {
+
+        unsigned long long value;
+        return watch(table,
+                     where,
+                     [expected](unsigned long long v) -> bool { return v != expected; },
+                     true,
+                     std::chrono::steady_clock::now() + t_wait,
+                     value);
+    }
+
+
+
+    unsigned long long DivSeg::wait_until(Table& table,
+            size_t where,
+            const std::function<bool(unsigned long long)>& pred) noexcept(false) {
+
+        unsigned long long value;
+        watch(table, where, pred, false, std::chrono::steady_clock::time_point(), value);
+        return value;
+    }
+
+
+
     unsigned long long DivSeg::get_single_instance(const Table &table, size_t t_index) noexcept(false) {
-        std::unique_lock<std::mutex> lock(mtx);
-        unsigned long long ans = Array::get_single_instance(table, t_index);
-        return ans;
+        if(!optimistic){
+            std::shared_lock<RW_mutex> lock(mtx);
+            unsigned long long ans = load(table, t_index);
+            return ans;
+        }
+        for(;;){
+            size_t before = version.load(std::memory_order_acquire);
+            if(before & 1){  // a writer is inside
+                std::this_thread::yield();
+                continue;
+            }
+            try{
+                unsigned long long ans = load(table, t_index);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(version.load(std::memory_order_relaxed) == before)
+                    return ans;
+            }
+            catch(...){  // the position may have been read while the block was moved
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(version.load(std::memory_order_relaxed) == before)
+                    throw;
+            }
+        }
     }
 
 
 
     void DivSeg::set_single_instance(Table &table, size_t where, unsigned long long what) noexcept(false) {
-        std::unique_lock<std::mutex> lock(mtx);
+        std::unique_lock<DivSeg> lock(*this);
         Array::set_single_instance(table, where, what);
     }
 
 
 
+    unsigned char* DivSeg::atomic_element(Table& table, size_t where) const noexcept(false) {
+        if(where >= position.size/single_size)
+            throw std::runtime_error("There is no such element in the array!");
+        if(!atomic_width(table))
+            return nullptr;
+        return table.mutable_view(position.starter_address + where*single_size, single_size).data;
+    }
+
+
+
+    bool DivSeg::atomic_width(const Table& table) const noexcept(false) {
+#if defined(__GNUC__)
+        if(single_size != 1 && single_size != 2 && single_size != 4 && single_size != 8)
+            return false;
+        const unsigned char* src = table.view(position.starter_address, single_size).data;
+        return reinterpret_cast<uintptr_t>(src) % single_size == 0;  // the elements after the first are aligned alike
+#else
+        return false;
+#endif
+    }
+
+
+
+    unsigned long long DivSeg::load(const Table& table, size_t where) const noexcept(false) {
+        if(!atomic_width(table))
+            return Array::get_single_instance(table, where);
+        if(where >= position.size/single_size)
+            throw std::runtime_error("Unexpected index to read!");
+        const unsigned char* src = table.view(position.starter_address + where*single_size, single_size).data;
+        switch(single_size){
+            case 1:
+                return atomic_load<uint8_t>(src, table.get_order());
+            case 2:
+                return atomic_load<uint16_t>(src, table.get_order());
+            case 4:
+                return atomic_load<uint32_t>(src, table.get_order());
+            default:
+                return atomic_load<uint64_t>(src, table.get_order());
+        }
+    }
+
+
+
+    unsigned long long DivSeg::update(Table& table, size_t where, Atomic_op op, unsigned long long what) noexcept(false) {
+        unsigned long long mask = single_size < sizeof(unsigned long long) ? (1ULL << (single_size*8)) - 1 : ~0ULL;
+        if(op == Exchange_op && (what & ~mask))
+            throw std::runtime_error("The argument is too high to contain!");
+        what &= mask;
+        unsigned char* src;
+        unsigned long long old = 0;
+        {
+            std::shared_lock<RW_mutex> lock(mtx);  // the hardware atomics only exclude the writers and the moves
+            src = atomic_element(table, where);
+            if(src)
+                ++rmw_started;
+            switch(src ? single_size : 0){
+                case 1:
+                    old = atomic_apply<uint8_t>(src, op, what, table.get_order());
+                    break;
+                case 2:
+                    old = atomic_apply<uint16_t>(src, op, what, table.get_order());
+                    break;
+                case 4:
+                    old = atomic_apply<uint32_t>(src, op, what, table.get_order());
+                    break;
+                case 8:
+                    old = atomic_apply<uint64_t>(src, op, what, table.get_order());
+                    break;
+                default:
+                    break;
+            }
+            if(src)
+                ++rmw_done;
+        }
+        if(src){
+            notify();
+            return old;
+        }
+        std::unique_lock<DivSeg> lock(*this);
+        old = Array::get_single_instance(table, where);
+        Array::set_single_instance(table, where, apply(op, old, what) & mask);
+        return old;
+    }
+
+
+
+    unsigned long long DivSeg::fetch_add(Table& table, size_t where, unsigned long long what) noexcept(false) {
+        return update(table, where, Add_op, what);
+    }
+
+
+
+    unsigned long long DivSeg::fetch_sub(Table& table, size_t where, unsigned long long what) noexcept(false) {
+        return update(table, where, Sub_op, what);
+    }
+
+
+
+    unsigned long long DivSeg::fetch_and(Table& table, size_t where, unsigned long long what) noexcept(false) {
+        return update(table, where, And_op, what);
+    }
+
+
+
+    unsigned long long DivSeg::fetch_or(Table& table, size_t where, unsigned long long what) noexcept(false) {
+        return update(table, where, Or_op, what);
+    }
+
+
+
+    unsigned long long DivSeg::fetch_xor(Table& table, size_t where, unsigned long long what) noexcept(false) {
+        return update(table, where, Xor_op, what);
+    }
+
+
+
+    unsigned long long DivSeg::exchange(Table& table, size_t where, unsigned long long what) noexcept(false) {
+        return update(table, where, Exchange_op, what);
+    }
+
+
+
+    bool DivSeg::compare_exchange(Table& table,
+            size_t where,
+            unsigned long long& expected,
+            unsigned long long desired) noexcept(false) {
+        if(single_size < sizeof(unsigned long long) && (desired >> (single_size*8)))
+            throw std::runtime_error("The argument is too high to contain!");
+        unsigned char* src;
+        bool done = false;
+        {
+            std::shared_lock<RW_mutex> lock(mtx);
+            src = atomic_element(table, where);
+            if(single_size < sizeof(unsigned long long) && (expected >> (single_size*8))){  // can never be equal
+                expected = load(table, where);
+                return false;
+            }
+            if(src)
+                ++rmw_started;
+            switch(src ? single_size : 0){
+                case 1:
+                    done = atomic_compare_exchange<uint8_t>(src, expected, desired, table.get_order());
+                    break;
+                case 2:
+                    done = atomic_compare_exchange<uint16_t>(src, expected, desired, table.get_order());
+                    break;
+                case 4:
+                    done = atomic_compare_exchange<uint32_t>(src, expected, desired, table.get_order());
+                    break;
+                case 8:
+                    done = atomic_compare_exchange<uint64_t>(src, expected, desired, table.get_order());
+                    break;
+                default:
+                    break;
+            }
+            if(src)
+                ++rmw_done;
+        }
+        if(src){
+            if(done)
+                notify();
+            return done;
+        }
+        std::unique_lock<DivSeg> lock(*this);
+        unsigned long long old = Array::get_single_instance(table, where);
+        if(old != expected){
+            expected = old;
+            return false;
+        }
+        Array::set_single_instance(table, where, desired);
+        return true;
+    }
+
+
+
+    std::vector<unsigned long long> DivSeg::operator()(const Table& table,
+            size_t t_begin,
+            size_t t_end) noexcept(false) {
+
+        if(t_begin > t_end)
+            throw std::invalid_argument("Incorrect first index");
+        if(t_end >= (this->position.size)/single_size)
+            throw std::invalid_argument("Incorrect second index");
+        std::vector<unsigned long long> vec(t_end - t_begin + 1);
+        read_range(table, t_begin, vec.size(), vec.data());
+        return vec;
+    }
+
+
+
+    void DivSeg::read_range(const Table& table,
+            size_t t_begin,
+            size_t t_count,
+            unsigned long long* t_out) const noexcept(false) {
+
+        std::shared_lock<RW_mutex> lock(mtx);
+        if(!atomic_width(table)){
+            Array::read_range(table, t_begin, t_count, t_out);
+            return;
+        }
+        if(t_begin > position.size/single_size || t_count > position.size/single_size - t_begin)
+            throw std::out_of_range("The range exceeds the array!");
+        for(unsigned attempt = 0; attempt < range_retries; ++attempt){
+            size_t done = rmw_done.load();
+            for(size_t i = 0; i < t_count; ++i){  // one by one, the updates may run meanwhile
+                t_out[i] = load(table, t_begin + i);
+            }
+            if(rmw_started.load() == done)  // every update begun by now had finished before the run was read
+                return;
+        }
+        lock.unlock();
+        std::unique_lock<RW_mutex> exclusive(mtx);  // the updates wait, the version is kept as nothing is written
+        Array::read_range(table, t_begin, t_count, t_out);
+    }
+
+
+
+    void DivSeg::write_range(Table& table,
+            size_t t_begin,
+            const unsigned long long* t_in,
+            size_t t_count) noexcept(false) {
+
+        std::unique_lock<DivSeg> lock(*this);
+        Array::write_range(table, t_begin, t_in, t_count);
+    }
+
+
+
+    void DivSeg::fill(Table& table, unsigned long long what) noexcept(false) {
+        std::unique_lock<DivSeg> lock(*this);
+        Array::fill(table, what);
+    }
+
+
+
+    void DivSeg::copy_from(Table& table, const Array& src) noexcept(false) {
+        auto ds = dynamic_cast<const DivSeg*>(&src);
+        if(!ds || ds == this){
+            std::unique_lock<DivSeg> lock(*this);
+            Array::copy_from(table, src);
+            return;
+        }
+        std::unique_lock<DivSeg> lock(*this, std::defer_lock);
+        std::unique_lock<RW_mutex> src_lock(ds->mtx, std::defer_lock);  // excludes the updates as well
+        if(this < ds){  // in the order of addresses, so that copies in both directions do not deadlock
+            lock.lock();
+            src_lock.lock();
+        } else{
+            src_lock.lock();
+            lock.lock();
+        }
+        Array::copy_from(table, src);
+    }
+
+
+
+    void DivSeg::move_elements(Table& table, size_t t_from, size_t t_to, size_t t_count) noexcept(false) {
+        std::unique_lock<DivSeg> lock(*this);
+        Array::move_elements(table, t_from, t_to, t_count);
+    }
+
+
+
     bool Unit::operator==(const Unit& un) const {
         return(this->size == un.size && this->starter_address == un.starter_address);
     }
@@ -22,7 +22,16 @@ classes used in the application
 #include <functional>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include <condition_variable>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 
 
@@ -37,6 +46,14 @@ namespace manager{
     class Array;
     class Link;
     class DivSeg;
+    class Allocator;
+    class Index_allocator;
+    class Segregated_allocator;
+    class Buddy_allocator;
+    class Bitmap_allocator;
+    class Fit_policy;
+    class Compactor;
+    class RW_mutex;
 
     /// The keys used to identify the Entities
     enum Entity_ID{ Value_ID = 0,  ///< Defines the Entity as a Single Value
@@ -46,6 +63,36 @@ namespace manager{
             E_ERR };               ///< Used in undefined Entities. Will never appear normally.
 
 
+    /// The keys used to identify the allocation engines of a Table
+    enum Alloc_ID{ Index_ID = 0,  ///< Defines the engine as ordered indexes of free blocks with a fit policy
+            Segregated_ID,        ///< Defines the engine as segregated size-class free lists
+            Buddy_ID,             ///< Defines the engine as a buddy system of power-of-two blocks
+            Bitmap_ID,            ///< Defines the engine as a bitmap of fixed-size granules
+            A_ERR };              ///< Used in undefined engines. Will never appear normally.
+
+
+    /// The keys used to identify the fit policies of the Index engine
+    enum Fit_ID{ Best_fit = 0,  ///< Takes the smallest free block big enough, used by default
+            First_fit,          ///< Takes the free block big enough at the lowest address
+            Next_fit,           ///< Takes the next free block big enough after the previous allocation
+            Worst_fit,          ///< Takes the biggest free block
+            F_ERR };            ///< Used in undefined policies. Will never appear normally.
+
+
+    /// The orders the elements of the Entities are stored in
+    enum Byte_order{ Big_endian = 0,  ///< The portable order, used by default
+            Native_order };           ///< The order of the host, read and written with plain copies
+
+
+    /// The read-modify-write operations on the elements of the Dividable Segments
+    enum Atomic_op{ Add_op = 0,  ///< Adds the operand, wrapping around
+            Sub_op,              ///< Subtracts the operand, wrapping around
+            Exchange_op,         ///< Replaces the element with the operand
+            And_op,              ///< Applies a bitwise and
+            Or_op,               ///< Applies a bitwise or
+            Xor_op };            ///< Applies a bitwise xor
+
+
     /*!
      * \brief This structure describes the position of a memory block.
      *
@@ -67,6 +114,224 @@ namespace manager{
 
 
 
+    /*!
+     * \brief This structure describes a view of bytes lying in the Table's memory.
+     *
+     * It is a pointer and a length, so reading and writing through it
+     * needs no copies. The Byte is either const or mutable unsigned char.
+     * \note The view stays valid until the block it points to is freed or moved by a compaction.
+     */
+    template<typename Byte>
+    struct Span{
+        Byte* data;     ///< The first byte of the view
+        size_t size;    ///< The amount of bytes in the view
+
+        //! \brief The Span constructor initializing the data and size fields
+        Span(Byte* t_data, size_t t_size) : data(t_data), size(t_size) {};
+
+        //! \brief An operator giving access to a byte of the view
+        Byte& operator [](size_t index) const noexcept { return data[index]; }
+
+        //! \brief A method returning the beginning of the view
+        Byte* begin() const noexcept { return data; }
+
+        //! \brief A method returning the end of the view
+        Byte* end() const noexcept { return data + size; }
+    };
+
+    typedef Span<const unsigned char> View;       ///< A read-only view of the Table's memory
+    typedef Span<unsigned char> Mutable_view;     ///< A writable view of the Table's memory
+
+
+
+    //! \brief A function to reverse the byte order of a 1-byte number, which is the number itself.
+    inline uint8_t byte_swap(uint8_t x) noexcept { return x; }
+
+    //! \brief A function to reverse the byte order of a 2-byte number.
+    inline uint16_t byte_swap(uint16_t x) noexcept {
+#if defined(__GNUC__)
+        return __builtin_bswap16(x);
+#else
+        return static_cast<uint16_t>((x << 8) | (x >> 8));
+#endif
+    }
+
+    //! \brief A function to reverse the byte order of a 4-byte number.
+    inline uint32_t byte_swap(uint32_t x) noexcept {
+#if defined(__GNUC__)
+        return __builtin_bswap32(x);
+#else
+        return (uint32_t(byte_swap(uint16_t(x))) << 16) | byte_swap(uint16_t(x >> 16));
+#endif
+    }
+
+    //! \brief A function to reverse the byte order of an 8-byte number.
+    inline uint64_t byte_swap(uint64_t x) noexcept {
+#if defined(__GNUC__)
+        return __builtin_bswap64(x);
+#else
+        return (uint64_t(byte_swap(uint32_t(x))) << 32) | byte_swap(uint32_t(x >> 32));
+#endif
+    }
+
+
+
+    /*!
+     * \brief A function telling whether the elements of the given order are to be byte swapped.
+     * \return true for the big-endian order on little-endian hosts
+     */
+    inline bool swapped(Byte_order order) noexcept {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return false;
+#else
+        return order == Big_endian;
+#endif
+    }
+
+
+
+    /*!
+     * \brief This structure describes how the elements of a fixed width are stored.
+     *
+     * The elements are kept in the big-endian order by default or in
+     * the order of the host. For the widths of 1, 2, 4 and 8 bytes
+     * the T is the unsigned type of that width, so reading or writing
+     * an element is a single load or store, followed by a byte swap
+     * when the orders differ.
+     * \sa Byte_order
+     */
+    template<typename T>
+    struct Codec{
+        //! \brief A method to read an element from the given bytes.
+        static T decode(const unsigned char* src, Byte_order order = Big_endian) noexcept {
+            T v;
+            std::memcpy(&v, src, sizeof(T));
+            return swapped(order) ? byte_swap(v) : v;
+        }
+
+        //! \brief A method to write an element to the given bytes.
+        static void encode(unsigned char* dst, T what, Byte_order order = Big_endian) noexcept {
+            if(swapped(order))
+                what = byte_swap(what);
+            std::memcpy(dst, &what, sizeof(T));
+        }
+    };
+
+
+
+    /*!
+     * \brief This class describes a typed view of the elements of an Entity.
+     *
+     * It gives access to the elements of a fixed width in place,
+     * with no bounds checks on the widths and no copies.
+     * \note The view does not lock the Entity, Dividable Segments
+     * shared between threads should be accessed through their own methods.
+     * \sa Entity::get_elements(Table&), Codec
+     */
+    template<typename T>
+    class Elements{
+    private:
+        unsigned char* data;    ///< The first byte of the first element
+        size_t length;          ///< The amount of elements
+        Byte_order order;       ///< The order the elements are stored in
+    public:
+        //! \brief The constructor of the view of the given bytes.
+        Elements(Mutable_view bytes, Byte_order t_order) : data(bytes.data),
+                                                           length(bytes.size / sizeof(T)),
+                                                           order(t_order) {}
+
+        //! \brief A method returning the amount of elements.
+        size_t size() const noexcept { return length; }
+
+        //! \brief A method reading the element at the given index.
+        T get(size_t index) const noexcept { return Codec<T>::decode(data + index*sizeof(T), order); }
+
+        //! \brief A method writing the element at the given index.
+        void set(size_t index, T what) const noexcept { Codec<T>::encode(data + index*sizeof(T), what, order); }
+    };
+
+
+
+    /*!
+     * \brief This structure describes the result of a Table compaction.
+     *
+     * It is returned by the Table after the live blocks
+     * have been slid together.
+     */
+    struct Compaction{
+        size_t bytes_moved;                 ///< The amount of bytes copied to their new places
+        size_t entities_moved;              ///< The amount of blocks relocated
+        std::chrono::microseconds pause;    ///< The time the Table was locked for
+
+        //! \brief The default Compaction constructor
+        Compaction() : bytes_moved(0), entities_moved(0), pause(0) {};
+    };
+
+
+
+    /*!
+     * \brief This class describes a lock shared by the readers and exclusive for the writers.
+     *
+     * Any number of readers may hold the lock at once, a writer
+     * waits for them to leave and then holds it alone. With the
+     * writer preference the new readers wait behind the queued
+     * writers, so the writers are not starved by a steady stream
+     * of reads. It meets the SharedMutex requirements, so it is
+     * used with std::unique_lock and std::shared_lock.
+     * \sa DivSeg
+     */
+    class RW_mutex{
+    private:
+        mutable std::mutex mtx;                 ///< The mutex protecting the state of the lock
+        std::condition_variable readers_ready;  ///< A condition variable signalizing the readers may enter
+        std::condition_variable writers;        ///< A condition variable signalizing a writer may enter
+        size_t readers;                         ///< The amount of readers holding the lock
+        size_t writers_waiting;                 ///< The amount of writers queued for the lock
+        bool writing;                           ///< This field tells whether a writer holds the lock
+        bool writer_preference;                 ///< This field tells whether the queued writers go before new readers
+
+        //! \brief A method telling whether a reader may enter now, the mutex must be locked.
+        bool readable() const noexcept { return !writing && !(writer_preference && writers_waiting); }
+    public:
+        /*!
+         * \brief The constructor of an unlocked RW_mutex.
+         * \param t_writer_preference whether the queued writers go before new readers
+         */
+        explicit RW_mutex(bool t_writer_preference = false);
+
+        //! \brief Copying a lock is prohibited.
+        RW_mutex(const RW_mutex&) = delete;
+
+        //! \brief Copying a lock is prohibited.
+        RW_mutex& operator=(const RW_mutex&) = delete;
+
+        //! \brief A method to take the lock exclusively, waiting for the readers and writers to leave.
+        void lock();
+
+        //! \brief A method to take the lock exclusively if it is free.
+        bool try_lock();
+
+        //! \brief A method to release the exclusive lock.
+        void unlock();
+
+        //! \brief A method to take the lock shared with other readers, waiting for the writers.
+        void lock_shared();
+
+        //! \brief A method to take the lock shared with other readers if no writer holds or awaits it.
+        bool try_lock_shared();
+
+        //! \brief A method to release the shared lock.
+        void unlock_shared();
+
+        //! \brief A method to turn the writer preference on or off.
+        void set_writer_preference(bool t_writer_preference);
+
+        //! \brief A method telling whether the writer preference is on.
+        bool get_writer_preference() const;
+    };
+
+
+
     /*!
      * \brief This abstract class describes an Entity.
      *
@@ -95,156 +360,1221 @@ namespace manager{
         Entity(Entity&&) noexcept;
 
         /*!
-         * \brief A pure virtual clone method.
-         * \return A clone of this class object
-         * \sa create_link(std::string), show(const Table&, std::ostream&), and run(Table&, std::ostream&)
+         * \brief A pure virtual clone method.
+         * \return A clone of this class object
+         * \sa create_link(std::string), show(const Table&, std::ostream&), and run(Table&, std::ostream&)
+         */
+        virtual Entity* clone() const = 0;
+
+        /*!
+         * \brief A pure virtual method for creating links.
+         * \return A link to this Entity
+         * \sa clone(), show(const Table&, std::ostream&), and run(Table&, std::ostream&)
+         */
+        virtual Entity* create_link(std::string) const = 0;
+
+        /*!
+         * \brief A pure virtual show method.
+         * \sa create_link(std::string), clone(), and run(Table&, std::ostream&)
+         */
+        virtual std::ostream& show(const Table&, std::ostream&) const = 0;
+
+        /*!
+         * \brief A pure virtual run method.
+         * The method is used to interact with the user
+         * \sa create_link(std::string), show(const Table&, std::ostream&), and clone()
+         */
+        virtual std::ostream& run(Table&, std::ostream&) = 0;
+
+        /*!
+         * \brief A method to set the Entity's ID.
+         * \sa e_id
+         */
+        void set_id(Entity_ID id) noexcept { e_id = id; }
+
+        /*!
+         * \brief A method to set the Entity's data position.
+         * \sa position
+         */
+        void set_pos(Unit un) noexcept { position = un; }
+
+        /*!
+         * \brief A method to move the Entity's data position, keeping its size.
+         * \note The size is not written, so it may be read while the Table moves the Entity.
+         * \sa Table::relocate(std::vector<Entity*>&, size_t)
+         */
+        void move_to(size_t t_strt) noexcept { position.starter_address = t_strt; }
+
+        /*!
+         * \brief A virtual method to lock the Entity's data while it is moved in the Table.
+         * \note Does nothing by default, only the Entities shared between threads need it.
+         * \sa unlock(), Table::compact()
+         */
+        virtual void lock() {}
+
+        /*!
+         * \brief A virtual method to unlock the Entity's data once it is moved.
+         * \sa lock()
+         */
+        virtual void unlock() {}
+
+        /*!
+         * \brief A method to set the Entity's name.
+         */
+        void set_name(const std::string& t_name) noexcept { name = t_name; }
+
+        /*!
+         * \brief A method to set the Entity's single_size.
+         * \sa single_size
+         */
+        void set_single_size(size_t sz) { single_size = sz; }
+
+        /*!
+         * \brief A method to get the Entity's position.
+         */
+        Unit get_pos() const noexcept { return position; }
+
+        /*!
+         * \brief A method to get the Entity's single_size.
+         * \sa single_size
+         */
+        size_t get_single_size() const noexcept { return single_size; }
+
+        /*!
+         * \brief A method to get the Entity's size in the memory.
+         * \sa Unit
+         */
+        size_t get_size() const noexcept { return  position.size; }
+
+        /*!
+         * \brief A method to get the Entity's ID.
+         */
+        Entity_ID get_entity_id() const noexcept { return e_id; }
+
+        /*!
+         * \brief A method to get the Entity's name.
+         */
+        std::string get_name() const noexcept { return name; }
+
+        /*!
+         * \brief A method to get the Entity's refs count.
+         */
+        size_t get_refs_count() const noexcept { return refs; }
+
+
+        /*!
+         * \brief A method to increment the references counter for the Entity.
+         * \sa refs
+         */
+        void increment_refs() noexcept { ++refs; }
+        /*!
+         * \brief A method to decrement the references counter for the Entity.
+         * \sa refs
+         */
+        void decrement_refs() noexcept { --refs; }
+
+        /*!
+         * \brief A static fabric method to create Entities.
+         * \param e_id the ID of the Entity
+         * \param single_size the size of 1 element(for arrays) or of the value(for single values)
+         * \param t_name The name to be iven to the Entity
+         */
+        static Entity* generate_Entity(Entity_ID e_id,
+                size_t single_size,
+                const std::string& t_name = "def") noexcept(false);
+
+        /*!
+         * \brief A method to get a typed view of the Entity's elements.
+         * \param table the table the Entity is stored in
+         * \return the view of all elements
+         * \note Throws std::domain_error if the size of T is not the size of the elements.
+         * \sa Elements
+         */
+        template<typename T>
+        Elements<T> get_elements(Table& table) const noexcept(false);
+
+        //! \brief Just a virtual default destructor.
+        virtual ~Entity() = default;
+    };
+
+
+
+    /*!
+     * \brief This abstract class describes the way a free block is chosen for a request.
+     *
+     * The Fit_policy class is the abstract class used by the Index engine
+     * to pick one of its free blocks. The engine cuts the block and keeps
+     * its indexes, the policy only looks at them, so a policy of any other
+     * kind may be plugged in by deriving from this class.
+     * \sa Index_allocator, Table::set_policy(Fit_ID)
+     */
+    class Fit_policy{
+    protected:
+        /*!
+         * \brief A method telling whether a request fits in a free block.
+         * \return true if the block is big enough, the alignment padding included
+         */
+        static bool fits(size_t t_strt, size_t t_block, size_t t_size, size_t t_align) noexcept;
+    public:
+        /*!
+         * \brief A pure virtual method to choose a free block for a request.
+         * \param by_address the sizes of the free blocks by their addresses
+         * \param by_size the free blocks as (size, address) pairs
+         * \param t_size the requested size
+         * \param t_align the alignment of the block start, a power of two
+         * \return the whole free block chosen, or an empty Unit if none fits
+         */
+        virtual Unit choose(const std::map<size_t, size_t>& by_address,
+                const std::set<std::pair<size_t, size_t>>& by_size,
+                size_t t_size,
+                size_t t_align) = 0;
+
+        /*!
+         * \brief A static fabric method to create the fit policies.
+         * \param f_id the ID of the policy
+         */
+        static Fit_policy* generate_Fit_policy(Fit_ID f_id) noexcept(false);
+
+        //! \brief Just a virtual default destructor.
+        virtual ~Fit_policy() = default;
+    };
+
+
+
+    /*!
+     * \brief This class describes the best-fit policy.
+     * \note The size index gives the smallest block big enough in O(log n).
+     */
+    class Best_fit_policy : public Fit_policy{
+    public:
+        //! \brief A method walking the size index up from the requested size.
+        Unit choose(const std::map<size_t, size_t>& by_address,
+                const std::set<std::pair<size_t, size_t>>& by_size,
+                size_t t_size,
+                size_t t_align) override;
+    };
+
+
+
+    /*!
+     * \brief This class describes the first-fit policy.
+     * \note The lower addresses are filled first, the search is linear.
+     */
+    class First_fit_policy : public Fit_policy{
+    public:
+        //! \brief A method walking the address index up from the start of the memory.
+        Unit choose(const std::map<size_t, size_t>& by_address,
+                const std::set<std::pair<size_t, size_t>>& by_size,
+                size_t t_size,
+                size_t t_align) override;
+    };
+
+
+
+    /*!
+     * \brief This class describes the next-fit policy.
+     * \note The search goes on from where the previous allocation ended,
+     * wrapping around, so the allocations spread over the whole memory.
+     */
+    class Next_fit_policy : public Fit_policy{
+    private:
+        size_t rover;   ///< The end of the previous allocation
+
+    public:
+        //! \brief The constructor starting the search at the start of the memory.
+        Next_fit_policy() : rover(0) {};
+
+        //! \brief A method walking the address index up from the roving pointer.
+        Unit choose(const std::map<size_t, size_t>& by_address,
+                const std::set<std::pair<size_t, size_t>>& by_size,
+                size_t t_size,
+                size_t t_align) override;
+    };
+
+
+
+    /*!
+     * \brief This class describes the worst-fit policy.
+     * \note The size index gives the biggest block in O(1), its remainder stays big.
+     */
+    class Worst_fit_policy : public Fit_policy{
+    public:
+        //! \brief A method walking the size index down from the biggest block.
+        Unit choose(const std::map<size_t, size_t>& by_address,
+                const std::set<std::pair<size_t, size_t>>& by_size,
+                size_t t_size,
+                size_t t_align) override;
+    };
+
+
+
+    /*!
+     * \brief This abstract class describes an allocation engine.
+     *
+     * The Allocator class is the abstract class used by the Table
+     * to keep track of its free memory. It is a Base class for the
+     * engines which decide where the requested blocks are placed.
+     * The engines do not touch the memory itself, they only
+     * manage the Units describing it.
+     */
+    class Allocator{
+    public:
+        /*!
+         * \brief A pure virtual method to take a block from the free memory.
+         * \param t_size the requested size
+         * \param t_align the alignment of the block start, a power of two
+         * \return a Unit describing the block, or an empty Unit if no block fits
+         * \note The padding skipped to align the block stays free.
+         * \sa release(Unit), extend(Unit), align_up(size_t, size_t)
+         */
+        virtual Unit allocate(size_t t_size, size_t t_align) = 0;
+
+        /*!
+         * \brief A method to round an address up to an alignment.
+         * \param t_strt the address to be aligned
+         * \param t_align the alignment, a power of two
+         * \return the lowest multiple of t_align not less than t_strt
+         */
+        static size_t align_up(size_t t_strt, size_t t_align) noexcept;
+
+        /*!
+         * \brief A pure virtual method to return a block to the free memory.
+         * \param un the block to be freed
+         * \note Throws std::invalid_argument if the block is found to be free already.
+         * \sa allocate(size_t)
+         */
+        virtual void release(Unit un) noexcept(false) = 0;
+
+        /*!
+         * \brief A pure virtual method to give the engine memory it has never seen.
+         * \param un the new block, used when the Table grows
+         * \sa allocate(size_t)
+         */
+        virtual void extend(Unit un) = 0;
+
+        /*!
+         * \brief A pure virtual method to count the free memory.
+         * \return the total size of the free blocks
+         */
+        virtual size_t free_size() const = 0;
+
+        /*!
+         * \brief A pure virtual method to find the biggest free block.
+         * \return the size of the biggest free block
+         */
+        virtual size_t largest_free() const = 0;
+
+        /*!
+         * \brief A method to merge the neighbouring free blocks.
+         * \note Does nothing by default, the engines merging blocks on release do not need it.
+         * It is never called on the allocation path, only through Table::defragmentation().
+         */
+        virtual void defragmentation() {}
+
+        /*!
+         * \brief A pure virtual method to list the free memory.
+         * \return the free blocks in the address order
+         */
+        virtual std::vector<Unit> get_free_blocks() const = 0;
+
+        /*!
+         * \brief A pure virtual method to take a free block out as a whole.
+         * \param un the free block to be taken
+         * \return false if there is no free block exactly like this one
+         * \note Used by the incremental compaction to fill a hole with the block following it.
+         */
+        virtual bool take(Unit un) = 0;
+
+        /*!
+         * \brief A pure virtual method to forget all the free blocks.
+         * \note Used by the compaction, which gives the new free memory back through extend(Unit).
+         */
+        virtual void clear() = 0;
+
+        /*!
+         * \brief A method telling whether the allocated blocks may be moved to any address.
+         * \sa Table::compact()
+         */
+        virtual bool movable() const noexcept { return true; }
+
+        /*!
+         * \brief A method to change the way the engine chooses the free blocks.
+         * \param t_policy the new policy, the engine takes it over
+         * \note Throws std::domain_error by default, the engines with no fit policy
+         * choose the blocks by their structure. The policy is deleted anyway.
+         * \sa Fit_policy
+         */
+        virtual void set_policy(Fit_policy* t_policy) noexcept(false);
+
+        /*!
+         * \brief A static fabric method to create the allocation engines.
+         * \param a_id the ID of the engine
+         * \param un the memory the engine manages initially
+         */
+        static Allocator* generate_Allocator(Alloc_ID a_id, Unit un) noexcept(false);
+
+        //! \brief Just a virtual default destructor.
+        virtual ~Allocator() = default;
+    };
+
+
+
+    /*!
+     * \brief This class describes the allocation engine over indexes of free blocks.
+     *
+     * The free blocks are indexed twice: by their addresses and by
+     * their sizes. A fit policy chooses the block from the indexes, the
+     * best fit taking the smallest block big enough from the size index,
+     * the address index gives the neighbours of a released block,
+     * so the validation and the insertion are O(log n).
+     * A released block is merged with its free neighbours at once,
+     * so no two free blocks are ever adjacent.
+     */
+    class Index_allocator : public Allocator{
+    private:
+        std::map<size_t, size_t> by_address;            ///< The sizes of the free blocks by their addresses
+        std::set<std::pair<size_t, size_t>> by_size;    ///< The free blocks as (size, address) pairs
+        size_t total;                       ///< The total size of the free blocks
+        Fit_policy* policy;                 ///< The way the free block is chosen for a request
+
+        //! \brief A method to put a free block into both indexes.
+        void insert(Unit un);
+
+        //! \brief A method to take a free block out of both indexes.
+        void erase(std::map<size_t, size_t>::iterator it);
+
+        //! \brief A method to index a free block merged with its free neighbours.
+        void coalesce(Unit un);
+    public:
+        /*!
+         * \brief The constructor of the engine managing the given memory.
+         * \param un the memory managed initially
+         * \param t_policy the way the free blocks are chosen, the engine takes it over, best fit if none
+         */
+        explicit Index_allocator(Unit un, Fit_policy* t_policy = nullptr);
+
+        //! \brief The engine cannot be copied, it owns its policy.
+        Index_allocator(const Index_allocator&) = delete;
+
+        /*!
+         * \brief A method taking the free block chosen by the policy, the alignment padding included.
+         * \sa Allocator, Fit_policy
+         */
+        Unit allocate(size_t t_size, size_t t_align) override;
+
+        /*!
+         * \brief A method validating the block against its neighbours and merging it with them.
+         * \sa Allocator
+         */
+        void release(Unit un) noexcept(false) override;
+
+        //! \brief A method adding new memory to the free tail.
+        void extend(Unit un) override;
+
+        //! \brief A method returning the free memory counted on the go.
+        size_t free_size() const override { return total; }
+
+        //! \brief A method returning the biggest size from the size index.
+        size_t largest_free() const override;
+
+        //! \brief A method listing the address index.
+        std::vector<Unit> get_free_blocks() const override;
+
+        //! \brief A method emptying both indexes.
+        void clear() override;
+
+        //! \brief A method taking a free block out, looking the block up in the address index.
+        bool take(Unit un) override;
+
+        /*!
+         * \brief A method replacing the fit policy.
+         * \note Throws std::invalid_argument if there is no policy.
+         */
+        void set_policy(Fit_policy* t_policy) noexcept(false) override;
+
+        //! \brief The destructor deleting the fit policy.
+        ~Index_allocator() override { delete policy; }
+    };
+
+
+
+    /*!
+     * \brief This class describes the segregated-fit allocation engine.
+     *
+     * The free blocks are kept in lists by their size classes,
+     * class k holding the blocks from 2^k to 2^(k+1) - 1 bytes long.
+     * A mask of the non-empty classes lets the allocation pick
+     * a fitting class in O(1), and the blocks are merged with their
+     * neighbours on release by looking up their borders in hash tables.
+     * A released block is validated by a bitmap of the ends of the free
+     * blocks, a bit per byte, summed up by bitmaps of a bit per word:
+     * the first free block ending past its start must not begin before
+     * its end, and that block is found in O(log64 N) word steps.
+     * \note The bitmap takes an eighth of the size of the managed memory.
+     */
+    class Segregated_allocator : public Allocator{
+    private:
+        static const size_t classes = sizeof(size_t) * 8;   ///< The amount of size classes
+        std::list<Unit> lists[classes];     ///< The free blocks of each size class
+        size_t nonempty;                    ///< The mask of the size classes having free blocks
+        size_t total;                       ///< The total size of the free blocks
+        static const size_t word_bits = sizeof(unsigned long long) * 8;   ///< The amount of addresses in a word of the bitmap
+        std::unordered_map<size_t, std::list<Unit>::iterator> by_start;  ///< The free blocks by their start
+        std::unordered_map<size_t, std::list<Unit>::iterator> by_end;    ///< The free blocks by their end
+        std::vector<std::vector<unsigned long long>> ends;  ///< The bitmap of the free block ends, then a bit per non-empty word of the level below, up to one word
+        size_t first;                       ///< The address the bitmap starts at, a multiple of word_bits
+        mutable size_t largest;             ///< The size of the biggest free block, unless stale
+        mutable bool stale;                 ///< This field tells whether the biggest block was taken out since
+
+        //! \brief A method to put a free block into its size class list.
+        void insert(Unit un);
+
+        //! \brief A method to take a free block out of its size class list.
+        void erase(std::list<Unit>::iterator it);
+
+        //! \brief A method to widen the bitmap of ends to the addresses of the block and both its borders.
+        void cover(Unit un);
+
+        //! \brief A method to set or clear the bit of an end, updating the levels above.
+        void mark_end(size_t t_end, bool t_set);
+
+        /*!
+         * \brief A method to find the lowest end of a free block not below an address.
+         * \return the end, or zero if there is none
+         */
+        size_t next_end(size_t t_from) const;
+    public:
+        //! \brief The constructor of the engine managing the given memory.
+        explicit Segregated_allocator(Unit un);
+
+        /*!
+         * \brief A method taking a block from the smallest class guaranteed to fit.
+         * \note Falls back to a search in the classes which may fit when all bigger ones are empty.
+         * \sa Allocator
+         */
+        Unit allocate(size_t t_size, size_t t_align) override;
+
+        /*!
+         * \brief A method validating the block against its neighbours, merging it with them and filing it by size.
+         * \note Throws std::invalid_argument if the block overlaps a free one.
+         * \sa Allocator
+         */
+        void release(Unit un) noexcept(false) override;
+
+        //! \brief A method widening the bitmap of ends and filing the new memory as a free block.
+        void extend(Unit un) override;
+
+        //! \brief A method returning the free memory counted on the go.
+        size_t free_size() const override { return total; }
+
+        /*!
+         * \brief A method returning the biggest block kept on the go.
+         * \note Once the biggest block is taken out, only the highest non-empty class is searched again.
+         */
+        size_t largest_free() const override;
+
+        //! \brief A method collecting the blocks of all classes sorted by their addresses.
+        std::vector<Unit> get_free_blocks() const override;
+
+        //! \brief A method emptying all the class lists.
+        void clear() override;
+
+        //! \brief A method taking a free block out, looking the block up by its start.
+        bool take(Unit un) override;
+
+        //! \brief A trivial destructor
+        ~Segregated_allocator() override = default;
+    };
+
+
+
+    /*!
+     * \brief This class describes the buddy allocation engine.
+     *
+     * The memory is split into blocks of 2^k bytes placed at addresses
+     * divisible by their size. A request is rounded up to such a block,
+     * bigger blocks being split in halves on the way, and a released block
+     * is merged with its buddy as long as the buddy is free, so both
+     * operations take O(log N) steps.
+     * \note The rounding is not given back until the block is released,
+     * and the free memory does not include it.
+     */
+    class Buddy_allocator : public Allocator{
+    private:
+        static const size_t orders = sizeof(size_t) * 8;    ///< The amount of block orders
+        std::set<size_t> free_lists[orders];                ///< The addresses of free blocks of each order, ordered
+        size_t nonempty;                    ///< The mask of the orders having free blocks
+        size_t total;                       ///< The total size of the free blocks
+
+        /*!
+         * \brief A method to put a free block back, merging it with its free buddies.
+         * \param t_strt the address of the block
+         * \param order the order of the block
+         */
+        void insert(size_t t_strt, size_t order);
+    public:
+        //! \brief The constructor of the engine managing the given memory.
+        explicit Buddy_allocator(Unit un);
+
+        /*!
+         * \brief A method taking the smallest free block of a sufficient order and splitting it.
+         * \note Every block is aligned to its size, so the order is raised to the alignment when searching.
+         * \sa Allocator
+         */
+        Unit allocate(size_t t_size, size_t t_align) override;
+
+        /*!
+         * \brief A method validating the block and merging it with its buddies.
+         * \note Throws std::invalid_argument for blocks which could not have been allocated here,
+         * the blocks inside a free block of a higher order or holding free blocks of lower orders included.
+         * \sa Allocator
+         */
+        void release(Unit un) noexcept(false) override;
+
+        //! \brief A method splitting the new memory into aligned blocks.
+        void extend(Unit un) override;
+
+        //! \brief A method returning the free memory counted on the go.
+        size_t free_size() const override { return total; }
+
+        //! \brief A method returning the size of the highest order having free blocks.
+        size_t largest_free() const override;
+
+        //! \brief A method collecting the blocks of all orders sorted by their addresses.
+        std::vector<Unit> get_free_blocks() const override;
+
+        //! \brief A method emptying all the order lists.
+        void clear() override;
+
+        /*!
+         * \brief A method telling the buddy blocks cannot be moved.
+         * \note A moved block would lose the alignment its order needs.
+         */
+        bool movable() const noexcept override { return false; }
+
+        //! \brief A method taking a free block out, looking the block up in the list of its order.
+        bool take(Unit un) override;
+
+        //! \brief A trivial destructor
+        ~Buddy_allocator() override = default;
+    };
+
+
+
+    /*!
+     * \brief This class describes the bitmap allocation engine.
+     *
+     * The memory is cut into granules of a fixed size, each having a bit
+     * set while it is free. The free runs are found a word at a time,
+     * counting the trailing zeros to jump over the granules of another
+     * state, and with AVX2 the words all in use are skipped four at once.
+     * The free memory takes a bit per granule and no heap objects.
+     * \note The requests are rounded up to whole granules, and the rounding
+     * is not given back until the block is released. The granules cut by the
+     * ends of the memory given to the engine are not used.
+     */
+    class Bitmap_allocator : public Allocator{
+    private:
+        static const size_t granule = 8;                            ///< The size of a granule
+        static const size_t word_bits = sizeof(unsigned long long) * 8;   ///< The amount of granules in a word
+        std::vector<unsigned long long> words;  ///< The bitmap, the bit of a free granule is set
+        size_t first;                       ///< The granule the bitmap starts at, a multiple of word_bits
+        size_t hint;                        ///< The first word which may have free granules
+        size_t total;                       ///< The total size of the free granules
+
+        //! \brief The free runs of a range of words, merged up from the words to the whole bitmap.
+        struct Run{
+            size_t prefix;      ///< The free granules at the start of the range
+            size_t suffix;      ///< The free granules at the end of the range
+            size_t longest;     ///< The longest free run inside the range
+            size_t length;      ///< The amount of granules in the range
+
+            //! \brief The constructor of a range of one word in use.
+            Run() : prefix(0), suffix(0), longest(0), length(word_bits) {};
+        };
+        std::vector<Run> runs;  ///< The segment tree over the words, the root at 1 and the words from leaves on
+        size_t leaves;          ///< The amount of the leaves, a power of two not less than the amount of words
+
+        //! \brief A method to build the tree of runs over the whole bitmap.
+        void build();
+
+        //! \brief A method to update the tree of runs once the words from t_from up to t_to have changed.
+        void refresh(size_t t_from, size_t t_to);
+
+        /*!
+         * \brief A method to find the next granule in a state.
+         * \param t_from the bit to start the search at
+         * \param t_free the state looked for
+         * \return the bit of the granule, or the size of the bitmap if there is none
+         */
+        size_t find(size_t t_from, bool t_free) const;
+
+        //! \brief A method to set the bits from t_from up to t_to to the state, updating the tree of runs.
+        void mark(size_t t_from, size_t t_to, bool t_free);
+    public:
+        //! \brief The constructor of the engine managing the given memory.
+        explicit Bitmap_allocator(Unit un);
+
+        /*!
+         * \brief A method taking the first free run of granules long enough, the alignment padding included.
+         * \sa Allocator
+         */
+        Unit allocate(size_t t_size, size_t t_align) override;
+
+        /*!
+         * \brief A method validating the granules of the block are in use and setting them free.
+         * \note Throws std::invalid_argument for blocks which could not have been allocated here.
+         * \sa Allocator
+         */
+        void release(Unit un) noexcept(false) override;
+
+        //! \brief A method widening the bitmap to cover the new memory and setting its granules free.
+        void extend(Unit un) override;
+
+        //! \brief A method returning the free memory counted on the go.
+        size_t free_size() const override { return total; }
+
+        //! \brief A method returning the longest free run kept at the root of the tree of runs.
+        size_t largest_free() const override;
+
+        //! \brief A method listing the free runs in the address order.
+        std::vector<Unit> get_free_blocks() const override;
+
+        //! \brief A method marking all the granules in use.
+        void clear() override;
+
+        /*!
+         * \brief A method telling the bitmap blocks cannot be moved.
+         * \note A moved block would not start on a granule.
+         */
+        bool movable() const noexcept override { return false; }
+
+        //! \brief A method taking a free run out, checking the granules around it are in use.
+        bool take(Unit un) override;
+
+        //! \brief A trivial destructor
+        ~Bitmap_allocator() override = default;
+    };
+
+
+
+    /*!
+     * \brief This class is used for storing the information
+     * and accessing it.
+     *
+     * Allows programs to allocate memory, write to it, read it,
+     * mark it as free. It also has a special defragmentation function
+     * for clearing the borders of deallocated memory parts.
+     * \note The memory grows online up to its limit when an allocation
+     * cannot be satisfied. The whole limit is reserved up front, so the
+     * memory never moves and the Units handed out stay valid. By default
+     * the limit is the capacity, so the growth and its reservation are
+     * only made when a limit is asked for.
+     */
+    class Table{
+    private:
+        static const size_t default_capacity = 500;     ///< The Table's memory size used by default
+        static const size_t default_limit = 0;          ///< The size the Table's memory may grow to by default, the capacity
+        static const size_t magazine_size = 64;         ///< The biggest block the threads keep in their caches
+        static const size_t magazine_capacity = 32;     ///< The amount of blocks of a size a thread keeps at most
+        static const size_t magazine_bytes = 4096;      ///< The most memory a thread keeps for a Table
+        std::vector<unsigned char> memory;  ///< This vector contains the actual memory of the system
+        std::atomic<size_t> capacity;       ///< This field describes the Table's current memory size
+        std::atomic<size_t> free_bytes;     ///< This field describes the free memory as counted by the engines
+        std::atomic<size_t> used_bytes;     ///< This field describes the memory handed out by allocate_memory
+        const size_t limit;                 ///< This field describes the size the memory may grow to
+        const Byte_order order;             ///< The order the Entities store their elements in
+
+        /*!
+         * \brief This structure describes an arena, a share of the memory with its own engine and lock.
+         *
+         * The threads allocate from their own arenas, so that they do not wait
+         * for each other, and go on to the neighbouring arenas only when theirs
+         * is exhausted. The memory the Table grows by goes to the arena which asked for it.
+         */
+        struct Arena{
+            Allocator* engine;  ///< The engine keeping track of the free blocks of the arena
+            std::mutex mtx;     ///< The mutex protecting the engine
+            std::atomic<size_t> largest;    ///< The biggest free block of the engine, written under the lock and read without it
+
+            //! \brief The Arena constructor taking over the engine of its memory
+            explicit Arena(Allocator* t_engine) : engine(t_engine), largest(t_engine->largest_free()) {};
+
+            //! \brief The destructor deleting the engine.
+            ~Arena() { delete engine; }
+        };
+        std::vector<Arena*> arenas;         ///< The arenas the memory is split between
+        std::vector<std::pair<size_t, size_t>> ranges;  ///< The starts of the memory ranges with their arenas, in address order
+        std::atomic<size_t> range_count;    ///< The amount of ranges published, the vector is reserved and never moves
+        std::mutex grow_mtx;                ///< The mutex serializing the growth, taken after mtx and before the arenas
+        std::mutex empty_mtx;               ///< The mutex the frees wait on while nothing is allocated
+        std::map<size_t, std::vector<Entity*>> residents;  ///< The Entities and their Links by their addresses
+        size_t sweep;                       ///< The address the incremental compaction goes on from
+        std::map<size_t, size_t> alignments;  ///< The alignments of the blocks by their addresses, if above one
+        std::mutex mtx;                     ///< The mutex object protecting from multitasking errors
+        std::mutex meta_mtx;                ///< The mutex protecting the residents and the alignments, taken after mtx
+        std::condition_variable not_empty;  ///< A condition variable signalizing the table can be written to, paired with empty_mtx
+        const size_t serial;                ///< The number telling this Table from the others in the thread caches
+        std::atomic<size_t> cached_bytes;   ///< The memory freed to the thread caches and not yet reused
+        std::atomic<size_t> queued;         ///< The amount of waiters, the frees skip the caches while there are any
+
+        static const size_t slab_width = sizeof(unsigned long long);        ///< The widest slot, that of a Value
+        static const size_t slab_slots = sizeof(unsigned long long) * 8;    ///< The amount of slots on a slab page
+
+        /*!
+         * \brief This structure describes a slab page, a block cut into slots of one width.
+         *
+         * The slots are handed out from a bitmap, the bit of a free slot is set.
+         * The page is returned to the arena once all of its slots are free.
+         * \note The pages are never moved by the compaction, the Entities in them are not attached.
+         */
+        struct Slab{
+            Unit page;                      ///< The block the slots are cut from
+            size_t width;                   ///< The size of the slots
+            unsigned long long free_slots;  ///< The bitmap of the free slots
+
+            //! \brief The Slab constructor marking all the slots free
+            Slab(Unit t_page, size_t t_width) : page(t_page), width(t_width), free_slots(~0ULL) {};
+        };
+        std::map<size_t, Slab> slabs;               ///< The slab pages by their addresses
+        std::set<size_t> partial[slab_width + 1];   ///< The pages having free slots by the widths, the lowest first
+        std::mutex slab_mtx;                        ///< The mutex protecting the slabs, taken before the arenas
+        std::atomic<size_t> slab_count;             ///< The amount of slab pages, the frees look them up only if any
+
+        /*!
+         * \brief This structure describes the blocks a thread keeps for a Table.
+         *
+         * The blocks freed by a thread are kept by their sizes and handed out
+         * again to the same thread without locking the Table. When a size has
+         * too many of them, half are returned to the engine at once.
+         * The Table reclaims the blocks of all the threads when the memory runs short.
+         */
+        struct Magazines{
+            std::vector<size_t> blocks[magazine_size + 1];  ///< The addresses of the kept blocks by their sizes
+            size_t bytes;                                   ///< The memory kept, at most magazine_bytes
+            std::mutex mtx;     ///< The mutex taken by the owning thread, contended only by the reclaiming ones
+
+            //! \brief The Magazines constructor starting with no blocks
+            Magazines() : bytes(0) {};
+        };
+
+        /*!
+         * \brief This structure describes the caches of a thread.
+         * \note The blocks are returned to the Tables still alive when the thread exits.
+         */
+        struct Thread_cache{
+            std::unordered_map<size_t, Magazines> tables;  ///< The caches by the serials of the Tables
+
+            //! \brief The destructor returning the blocks to their Tables.
+            ~Thread_cache();
+        };
+
+        static std::mutex live_mtx;                         ///< The mutex protecting the registry of the Tables
+        static std::unordered_map<size_t, Table*> live;     ///< The Tables alive by their serials
+        static std::atomic<size_t> serials;                 ///< The serial of the next Table
+        static thread_local Thread_cache cache;             ///< The caches of the calling thread
+        std::vector<Magazines*> caches;     ///< The caches the threads keep for this Table
+        std::mutex cache_mtx;               ///< The mutex protecting the caches, taken after mtx and before the Magazines
+
+        static const unsigned record_bits = 6;                      ///< The binary logarithm of the amount of parts of the allocation record
+        static const size_t record_shards = size_t(1) << record_bits;  ///< The amount of separately locked parts of the allocation record
+
+        /*!
+         * \brief This structure describes a part of the record of the allocated blocks.
+         *
+         * Every free is checked against the record before the block is cached
+         * or released, so a block is never freed twice, nor freed with another
+         * size, nor freed without having been allocated. The blocks are spread
+         * over the parts by their addresses, so the threads seldom share a lock.
+         */
+        struct Record{
+            std::unordered_map<size_t, std::pair<size_t, bool>> blocks;  ///< The sizes of the blocks by their addresses, and whether they are cached
+            std::mutex mtx;                                              ///< The mutex protecting the part, no other is taken under it
+        };
+        Record records[record_shards];      ///< The record of the allocated blocks, the slab slots excluded
+
+        /*!
+         * \brief This structure describes a thread waiting for memory.
+         *
+         * The waiters are queued in the order of arrival. The thread
+         * freeing memory allocates it for the waiters whose requests fit
+         * and wakes only them, each through its own condition variable.
+         */
+        struct Waiter{
+            size_t size;                    ///< The size requested
+            size_t align;                   ///< The alignment requested
+            Unit result;                    ///< The memory allocated for the waiter
+            bool done;                      ///< This field tells whether the memory has been allocated
+            std::condition_variable ready;  ///< A condition variable signalizing the memory is allocated
+
+            //! \brief The Waiter constructor initializing the requested size and alignment
+            Waiter(size_t t_size, size_t t_align) : size(t_size), align(t_align), result(), done(false) {};
+        };
+        std::list<Waiter*> waiters;         ///< The threads waiting for memory in the order of arrival
+
+        //! \brief A method returning the caches of the calling thread for this Table, registering them first.
+        Magazines& magazines();
+
+        /*!
+         * \brief A method to take a block from the cache of the calling thread.
+         * \param t_size the requested size
+         * \param t_align the alignment of the block
+         * \return the block, or an empty Unit if the cache has none fitting
+         * \note The Table is not locked.
+         */
+        Unit pop_cached(size_t t_size, size_t t_align);
+
+        /*!
+         * \brief A method to keep a freed block in the cache of the calling thread.
+         * \param t_strt the address of the block
+         * \param t_size the size of the block
+         * \return false if the block is to be freed to the engine instead, as when the cache holds magazine_bytes
+         * \note The Table is not locked, only an arena when the cache is full and half of it is returned.
+         */
+        bool push_cached(size_t t_strt, size_t t_size) noexcept(false);
+
+        /*!
+         * \brief A method to return cached blocks of one size to their arenas.
+         * \param t_size the size of the blocks
+         * \param t_blocks the addresses of the blocks
+         * \note The waiters are not served, the caller does it when there are any.
+         */
+        void release_cached(size_t t_size, const std::vector<size_t>& t_blocks);
+
+        /*!
+         * \brief A method returning the part of the allocation record an address belongs to.
+         *
+         * The address is mixed by a Fibonacci hash before its top bits pick the
+         * part, since the low bits of aligned blocks are mostly the same.
+         */
+        Record& record_of(size_t t_strt) { return records[(uint64_t(t_strt >> 4) * 0x9E3779B97F4A7C15ULL) >> (64 - record_bits)]; }
+
+        //! \brief A method to enter a block handed out by an engine in the allocation record.
+        void record(Unit un);
+
+        /*!
+         * \brief A method to check a freed block against the allocation record.
+         * \param t_strt the address of the block
+         * \param t_size the size of the block
+         * \param t_cache whether the block is kept in a cache, it is dropped from the record otherwise
+         * \note Throws std::invalid_argument if the block is not allocated as it is given.
+         */
+        void claim(size_t t_strt, size_t t_size, bool t_cache) noexcept(false);
+
+        //! \brief A method to mark a cached block as allocated again.
+        void reuse(size_t t_strt);
+
+        //! \brief A method to drop a block released to its arena from the allocation record.
+        void forget(size_t t_strt);
+
+        //! \brief A method to move a block in the allocation record when it is compacted.
+        void rekey(size_t t_from, size_t t_to);
+
+        /*!
+         * \brief A method to return all the blocks of a cache to their arenas.
+         * \param mags the cache of any thread
+         * \note The waiters are not served, the caller does it when there are any.
+         */
+        void drain(Magazines& mags);
+
+        /*!
+         * \brief A method to return the blocks cached by all the threads to their arenas and serve the waiters.
+         * \note The Table must be locked.
+         */
+        void reclaim();
+
+        /*!
+         * \brief A method to enlarge the memory so that a block of the given size fits.
+         * \param t_size the size of the block which could not be allocated
+         * \param t_arena the arena the new memory goes to
+         * \param t_seen the capacity the allocation failed at
+         * \return true if the memory has grown since t_seen, false if the limit is reached
+         * \note The memory at least doubles on every growth to keep it amortized,
+         * so the ranges never outnumber the arenas by more than the bits of the size.
+         * \sa memory, limit
          */
-        virtual Entity* clone() const = 0;
+        bool grow(size_t t_size, size_t t_arena, size_t t_seen);
+
+        //! \brief A method returning the arena of the calling thread.
+        size_t home_arena() const;
+
+        //! \brief A method returning the arena owning the given address, the Table needs no locking.
+        size_t arena_of(size_t t_strt) const;
 
         /*!
-         * \brief A pure virtual method for creating links.
-         * \return A link to this Entity
-         * \sa clone(), show(const Table&, std::ostream&), and run(Table&, std::ostream&)
+         * \brief A method to split a block at the borders of the arenas.
+         * \return the parts of the block with the arenas owning them
          */
-        virtual Entity* create_link(std::string) const = 0;
+        std::vector<std::pair<size_t, Unit>> split(Unit un) const;
 
         /*!
-         * \brief A pure virtual show method.
-         * \sa create_link(std::string), clone(), and run(Table&, std::ostream&)
+         * \brief A method to allocate a block from an arena.
+         * \note The arena is locked for the time of the allocation.
          */
-        virtual std::ostream& show(const Table&, std::ostream&) const = 0;
+        Unit take_from(Arena* arena, size_t t_size, size_t t_align);
 
         /*!
-         * \brief A pure virtual run method.
-         * The method is used to interact with the user
-         * \sa create_link(std::string), show(const Table&, std::ostream&), and clone()
+         * \brief A method to free a block to the arena owning it.
+         * \note The arena is locked for the time of the release.
          */
-        virtual std::ostream& run(Table&, std::ostream&) = 0;
+        void release_to(Unit un) noexcept(false);
 
         /*!
-         * \brief A method to set the Entity's ID.
-         * \sa e_id
+         * \brief A method to find the slab page holding an address.
+         * \return the page, or the end of the slabs if the address is in none
+         * \note The slab_mtx must be locked.
          */
-        void set_id(Entity_ID id) noexcept { e_id = id; }
+        std::map<size_t, Slab>::iterator slab_of(size_t t_strt);
 
         /*!
-         * \brief A method to set the Entity's data position.
-         * \sa position
+         * \brief A method to free a slot of a slab page.
+         * \param t_strt the address of the slot
+         * \param t_size the size of the slot
+         * \return false if the address is in no slab page
+         * \note Throws std::invalid_argument if the block is not a slot in use.
          */
-        void set_pos(Unit un) noexcept { position = un; }
+        bool free_slot(size_t t_strt, size_t t_size) noexcept(false);
+
+        //! \brief A method to find the biggest free block in all the arenas, kept by each arena, without their locks.
+        size_t largest_free() const noexcept;
+
+        //! \brief A method telling whether the engines of all the arenas can move blocks.
+        bool movable() const;
 
         /*!
-         * \brief A method to set the Entity's name.
+         * \brief A method to move a group of Entities sharing a block to another address.
+         * \param group the Entity and its Links
+         * \param t_strt the new address of the block
+         * \note The Entities are locked while their data is moved.
          */
-        void set_name(const std::string& t_name) noexcept { name = t_name; }
+        void relocate(std::vector<Entity*>& group, size_t t_strt);
 
         /*!
-         * \brief A method to set the Entity's single_size.
-         * \sa single_size
+         * \brief A method to allocate memory, growing the Table if needed, without waiting.
+         * \param t_size the requested size
+         * \param t_align the alignment of the block
+         * \return the allocated block, or an empty Unit if it does not fit
+         * \note Only the arenas are locked, the own one first and the neighbours after it.
          */
-        void set_single_size(size_t sz) { single_size = sz; }
+        Unit take_memory(size_t t_size, size_t t_align);
 
         /*!
-         * \brief A method to get the Entity's position.
+         * \brief A method to find the alignment a block was allocated with.
+         * \param t_strt the address of the block
+         * \return the alignment, one if none was requested
+         * \note The meta_mtx must be locked.
          */
-        Unit get_pos() const noexcept { return position; }
+        size_t alignment_of(size_t t_strt) const;
 
         /*!
-         * \brief A method to get the Entity's single_size.
-         * \sa single_size
+         * \brief A method to allocate memory for the queued waiters whose requests fit now.
+         * \note The Table must be locked.
+         * \sa Waiter
          */
-        size_t get_single_size() const noexcept { return single_size; }
+        void serve_waiters();
 
         /*!
-         * \brief A method to get the Entity's size in the memory.
-         * \sa Unit
+         * \brief A method to find the biggest block an arena may ever hold.
+         * \return the longest range of an arena, the last one counted as grown up to the limit
+         * \note A block never spans arenas, so the bigger requests can never be satisfied.
          */
-        size_t get_size() const noexcept { return  position.size; }
+        size_t biggest_block();
 
         /*!
-         * \brief A method to get the Entity's ID.
+         * \brief A method to allocate memory, waiting in the queue when it does not fit.
+         * \param t_size the requested size
+         * \param t_align the alignment of the block
+         * \param timed whether to stop waiting at the deadline
+         * \param deadline the time to stop waiting at
+         * \return the allocated block, or an empty Unit if the deadline has passed
+         * \sa Waiter
          */
-        Entity_ID get_entity_id() const noexcept { return e_id; }
-
+        Unit wait_memory(size_t t_size,
+                size_t t_align,
+                bool timed,
+                std::chrono::steady_clock::time_point deadline) noexcept(false);
+    public:
         /*!
-         * \brief A method to get the Entity's name.
+         * \brief The constructor of the Table.
+         * \param t_capacity the initial size of the memory
+         * \param t_limit the size the memory may grow to, it is never less than t_capacity, so zero keeps the memory as it is
+         * \param t_engine the ID of the allocation engine to be used
+         * \param t_order the order the Entities store their elements in
+         * \param t_arenas the amount of arenas the memory is split between, each with its own lock
+         * \sa Allocator, Byte_order
          */
-        std::string get_name() const noexcept { return name; }
+        explicit Table(size_t t_capacity = default_capacity,
+                size_t t_limit = default_limit,
+                Alloc_ID t_engine = Index_ID,
+                Byte_order t_order = Big_endian,
+                size_t t_arenas = 1) noexcept(false);
 
         /*!
-         * \brief A method to get the Entity's refs count.
+         * \brief The constructor of the Table with engines of any kind.
+         * \param t_capacity the initial size of the memory
+         * \param t_limit the size the memory may grow to, it is never less than t_capacity, so zero keeps the memory as it is
+         * \param t_factory the function creating the engine of each arena for the memory given,
+         * the Table takes the engines over
+         * \param t_order the order the Entities store their elements in
+         * \param t_arenas the amount of arenas the memory is split between, each with its own lock
+         * \note The engines derived from Allocator outside this library are plugged in this way.
+         * \sa Allocator, Byte_order
          */
-        size_t get_refs_count() const noexcept { return refs; }
+        Table(size_t t_capacity,
+                size_t t_limit,
+                const std::function<Allocator*(Unit)>& t_factory,
+                Byte_order t_order = Big_endian,
+                size_t t_arenas = 1) noexcept(false);
 
+        //! \brief The Table cannot be copied, it owns its memory and engine.
+        Table(const Table&) = delete;
 
         /*!
-         * \brief A method to increment the references counter for the Entity.
-         * \sa refs
+         * \brief A method to defragment the system's memory.
+         * \note The engines merge the free blocks on release, so it is not needed on allocation.
+         * \sa Allocator
          */
-        void increment_refs() noexcept { ++refs; }
+        void defragmentation();
+
         /*!
-         * \brief A method to decrement the references counter for the Entity.
-         * \sa refs
+         * \brief A method to change the way the engines choose the free blocks.
+         * \param t_policy the ID of the policy, each arena gets its own
+         * \note Throws std::domain_error if the engine has no fit policy.
+         * The blocks allocated already stay where they are.
+         * \sa Fit_policy, Index_allocator
          */
-        void decrement_refs() noexcept { --refs; }
+        void set_policy(Fit_ID t_policy) noexcept(false);
 
         /*!
-         * \brief A static fabric method to create Entities.
-         * \param e_id the ID of the Entity
-         * \param single_size the size of 1 element(for arrays) or of the value(for single values)
-         * \param t_name The name to be iven to the Entity
+         * \brief A method to change the way the engines choose the free blocks to a policy of any kind.
+         * \param t_factory the function creating the policy of each arena, the engines take the policies over
+         * \sa set_policy(Fit_ID)
          */
-        static Entity* generate_Entity(Entity_ID e_id,
-                size_t single_size,
-                const std::string& t_name = "def") noexcept(false);
+        void set_policy(const std::function<Fit_policy*()>& t_factory) noexcept(false);
 
-        //! \brief Just a virtual default destructor.
-        virtual ~Entity() = default;
-    };
+        /*!
+         * \brief A method to compact the system's memory by moving the live Entities together.
+         *
+         * The Entities attached to the Table are slid towards the start of
+         * the memory in the address order and their positions are rewritten,
+         * the Links sharing the positions included. Allocated memory not
+         * belonging to any attached Entity, the slab pages included, stays where it is.
+         * The blocks cached by the threads are reclaimed first.
+         * \return the amount of memory moved and the time the Table was locked for
+         * \warning The Entities which do not lock themselves, such as Values and Arrays,
+         * must not be read or written while the compaction runs.
+         * \sa attach(Entity*), compact_step(size_t, std::chrono::microseconds), Compaction
+         */
+        Compaction compact() noexcept(false);
 
+        /*!
+         * \brief A method to compact the system's memory a bit at a time.
+         *
+         * Goes on in the address order from where the previous step stopped,
+         * moving one Entity at a time down into the free hole before it,
+         * and starts over from the beginning once the end is reached.
+         * \param t_bytes the maximum amount of bytes to be moved in this step
+         * \param t_pause the time after which no more Entities are moved in this step
+         * \return the amount of memory moved and the time the Table was locked for
+         * \note The step stops once the next Entity to be moved would exceed t_bytes,
+         * and the next step goes on from it. The Entities bigger than t_bytes are only moved by compact().
+         * \sa compact(), Compactor
+         */
+        Compaction compact_step(size_t t_bytes, std::chrono::microseconds t_pause) noexcept(false);
 
+        /*!
+         * \brief A method to register an Entity or a Link placed in the Table.
+         * \param ent the Entity whose position is to be kept up to date on compaction
+         * \note The Entities in slab pages are not attached, they are never moved.
+         * \sa compact(), detach(Entity*)
+         */
+        void attach(Entity* ent);
 
-    /*!
-     * \brief This class is used for storing the information
-     * and accessing it.
-     *
-     * Allows programs to allocate memory, write to it, read it,
-     * mark it as free. It also has a special defragmentation function
-     * for clearing the borders of deallocated memory parts.
-     */
-    class Table{
-    private:
-        static const int max_size = 500;    ///< This field describes the Table's memory maximum size
-        std::vector<unsigned char> memory;  ///< This vector contains the actual memory of the system
-        std::vector<Unit> free_blocks;      ///< This vector contains descriptions of free blocks in memory
-        std::mutex mtx;                     ///< The mutex object protecting from multitasking errors
-        std::condition_variable not_empty;  ///< A condition variable signalizing the table can be written to
-        std::condition_variable not_full;   ///< A condition variable signalizing the table can be read from
-    public:
-        //! A trivial constructor
-        Table();
+        /*!
+         * \brief A method to forget an Entity or a Link placed in the Table.
+         *
+         * Once detached, the Entity is moved no more. An Entity owning its block
+         * takes the Links sharing the block along, the block is about to be freed.
+         * \param ent the Entity which is about to be freed or deleted
+         * \return the position of the Entity, read under the lock the compaction moves it under
+         * \sa attach(Entity*)
+         */
+        Unit detach(Entity* ent);
 
         /*!
-         * \brief A method to defragment the system's memory in case of memory shortage.
-         * \sa free_blocks
+         * \brief A method to read the position of an Entity placed in the Table while it may be moved.
+         * \return the position, read under the lock the compaction moves it under
          */
-        void defragmentation();
+        Unit position_of(const Entity* ent);
 
         /*!
          * \brief A method to mark a block of memory as free and available for allocation.
          * \param t_strt the starter address of memory to free
          * \param t_size the size of memory to free
-         * \sa free_blocks
+         * \note Throws std::invalid_argument if the block is not allocated as it is given.
+         * The slots of the slab pages go back to their pages. The other small blocks are kept
+         * in the cache of the calling thread without locking the Table, unless some threads are waiting for memory.
+         * \sa Allocator, flush_cache()
          */
         void mark_free(size_t t_strt, size_t t_size) noexcept(false);
 
+        /*!
+         * \brief A method to return the blocks cached by the calling thread to the engine.
+         * \sa get_cached()
+         */
+        void flush_cache();
+
         /*!
          * \brief A method to allocate memory from the table.
+         *
+         * Waits until the memory is freed when the request does not fit,
+         * the thread is only woken when its request has been satisfied.
+         * The start of the block is a multiple of the alignment counted from the start of the memory,
+         * which itself is aligned to alignof(std::max_align_t).
          * \param t_size the requested size
+         * \param t_align the alignment of the block, a power of two
          * \return a Unit describing the allocated memory position
-         * \sa Entity, Unit
+         * \note Throws std::runtime_error if the request can never be satisfied, e.g. it is bigger than
+         * any arena may grow to, std::invalid_argument if the alignment is not a power of two.
+         * \sa Entity, Unit, try_allocate(size_t, size_t), allocate_for(size_t, std::chrono::microseconds, size_t)
+         */
+        Unit allocate_memory(size_t t_size, size_t t_align = 1) noexcept(false);
+
+        /*!
+         * \brief A method to allocate memory from the table without waiting.
+         * \param t_size the requested size
+         * \param t_align the alignment of the block, a power of two
+         * \return a Unit describing the allocated memory position, or an empty Unit if it does not fit
+         * \sa allocate_memory(size_t, size_t)
+         */
+        Unit try_allocate(size_t t_size, size_t t_align = 1) noexcept(false);
+
+        /*!
+         * \brief A method to allocate memory from the table waiting for a limited time.
+         * \param t_size the requested size
+         * \param t_wait the time to wait for the memory to be freed
+         * \param t_align the alignment of the block, a power of two
+         * \return a Unit describing the allocated memory position, or an empty Unit on timeout
+         * \note Throws std::runtime_error if the request can never be satisfied, as allocate_memory does.
+         * \sa allocate_memory(size_t, size_t)
+         */
+        Unit allocate_for(size_t t_size, std::chrono::microseconds t_wait, size_t t_align = 1) noexcept(false);
+
+        /*!
+         * \brief A method to allocate a slot of a slab page for a small block.
+         *
+         * The blocks of up to the size of a Value share pages cut into slots
+         * of their size instead of fragmenting the memory one by one.
+         * The slots are aligned to the biggest power of two dividing their size.
+         * \param t_size the requested size
+         * \param t_align the alignment of the block, a power of two
+         * \return a Unit describing the allocated slot
+         * \note The blocks the slabs cannot hold, and those not fitting when the
+         * memory is exhausted, are allocated by allocate_memory(size_t, size_t).
+         * The slots are freed by mark_free(size_t, size_t) as any other block.
+         * \sa Slab, get_slab_pages()
          */
-        Unit allocate_memory(size_t t_size);
+        Unit allocate_slot(size_t t_size, size_t t_align = 1) noexcept(false);
 
         /*!
          * \brief A method to read bytes from the table.
@@ -265,10 +1595,163 @@ namespace manager{
          */
         void write(size_t t_strt,
                 size_t t_size,
-                std::vector<unsigned char>t_vec) noexcept(false);
+                const std::vector<unsigned char>& t_vec) noexcept(false);
 
-        //! \brief A trivial destructor
-        ~Table() = default;
+        /*!
+         * \brief A method to look at bytes of the table without copying them.
+         * \param t_strt the address to begin the view at
+         * \param t_size the size of the view
+         * \return a read-only view of the table's memory
+         * \sa memory, Span
+         */
+        View view(size_t t_strt, size_t t_size) const noexcept(false);
+
+        /*!
+         * \brief A method to get writable access to bytes of the table without copying them.
+         * \param t_strt the address to begin the view at
+         * \param t_size the size of the view
+         * \return a writable view of the table's memory
+         * \sa memory, Span
+         */
+        Mutable_view mutable_view(size_t t_strt, size_t t_size) noexcept(false);
+
+        /*!
+         * \brief A method to fill a block of the table with a repeated pattern.
+         * \param t_dst the block to be filled
+         * \param t_pattern the bytes to be repeated, the last copy is cut at the end of the block
+         * \note A single byte pattern is a memset, a longer one is copied in doubling runs.
+         * \sa copy(Unit, Unit), move(Unit, Unit)
+         */
+        void fill(Unit t_dst, const std::vector<unsigned char>& t_pattern) noexcept(false);
+
+        /*!
+         * \brief A method to copy a block of the table to another one.
+         * \param t_src the block to be copied
+         * \param t_dst the block to copy to, not smaller than t_src
+         * \note Throws std::invalid_argument if the blocks overlap.
+         * \sa move(Unit, Unit)
+         */
+        void copy(Unit t_src, Unit t_dst) noexcept(false);
+
+        /*!
+         * \brief A method to copy a block of the table to another one which may overlap it.
+         * \param t_src the block to be copied
+         * \param t_dst the block to copy to, not smaller than t_src
+         * \sa copy(Unit, Unit)
+         */
+        void move(Unit t_src, Unit t_dst) noexcept(false);
+
+        /*!
+         * \brief A method to get the current size of the Table's memory.
+         * \sa capacity
+         */
+        size_t get_capacity() const noexcept { return capacity; }
+
+        /*!
+         * \brief A method to get the size the Table's memory may grow to.
+         * \sa limit
+         */
+        size_t get_limit() const noexcept { return limit; }
+
+        /*!
+         * \brief A method to get the order the Entities store their elements in.
+         * \note The big-endian order keeps the memory portable between hosts,
+         * the native one lets the elements be copied as they are.
+         * \sa order
+         */
+        Byte_order get_order() const noexcept { return order; }
+
+        /*!
+         * \brief A method to get the amount of free memory in O(1).
+         * \note The memory an engine rounds the blocks up with is not free.
+         * \sa free_bytes
+         */
+        size_t get_free() const noexcept { return free_bytes; }
+
+        /*!
+         * \brief A method to get the amount of memory allocated in O(1).
+         * \sa used_bytes
+         */
+        size_t get_used() const noexcept { return used_bytes; }
+
+        /*!
+         * \brief A method to get the size of the biggest free block.
+         * \sa Allocator
+         */
+        size_t get_largest_free() const noexcept;
+
+        /*!
+         * \brief A method to get the amount of memory freed to the thread caches and not reused yet.
+         * \note That memory is counted neither as free nor as used.
+         * \sa flush_cache()
+         */
+        size_t get_cached() const noexcept { return cached_bytes; }
+
+        /*!
+         * \brief A method to get the amount of slab pages in O(1).
+         * \note The whole pages are counted as used memory.
+         * \sa allocate_slot(size_t, size_t)
+         */
+        size_t get_slab_pages() const noexcept { return slab_count; }
+
+        //! \brief The destructor deleting the allocation engine.
+        ~Table();
+    };
+
+
+
+    /*!
+     * \brief This class describes a background compaction worker.
+     *
+     * The Compactor runs a thread compacting a Table step by step,
+     * so that the Table is locked for a bounded time only and the
+     * other threads reading and writing it keep their latency.
+     * \sa Table::compact_step(size_t, std::chrono::microseconds)
+     */
+    class Compactor{
+    private:
+        Table* table;                           ///< The Table to be compacted
+        const size_t step_bytes;                ///< The maximum amount of bytes moved per step
+        const std::chrono::microseconds step_pause;  ///< The time after which a step stops moving
+        const std::chrono::milliseconds interval;    ///< The time to wait between the steps
+        bool running;                           ///< This field tells whether the worker should go on
+        Compaction total;                       ///< The sum of the reports of all steps made
+        std::thread worker;                     ///< The thread making the steps
+        mutable std::mutex mtx;                 ///< The mutex object protecting from multitasking errors
+        std::condition_variable wake;           ///< A condition variable signalizing the worker to stop
+
+        //! \brief The method run by the worker thread.
+        void work();
+    public:
+        //! \brief The default constructor of the Compactor has no meaning in this scope.
+        Compactor() = delete;
+
+        /*!
+         * \brief A basic constructor of the class.
+         * \param t_table the Table to be compacted
+         * \param t_bytes the maximum amount of bytes moved per step
+         * \param t_pause the time after which a step stops moving
+         * \param t_interval the time to wait between the steps
+         */
+        explicit Compactor(Table* t_table,
+                size_t t_bytes = 4096,
+                std::chrono::microseconds t_pause = std::chrono::microseconds(100),
+                std::chrono::milliseconds t_interval = std::chrono::milliseconds(10));
+
+        //! \brief A method to start the worker thread.
+        void start() noexcept(false);
+
+        //! \brief A method to stop the worker thread and wait for it.
+        void stop();
+
+        /*!
+         * \brief A method to get the total results of the steps made.
+         * \sa Compaction
+         */
+        Compaction get_total() const;
+
+        //! \brief The destructor stopping the worker.
+        ~Compactor();
     };
 
 
@@ -366,13 +1849,15 @@ namespace manager{
          * \param single_val the size of one block
          * \param e_id the id of the Entity to be created
          * \param t_name the name of the Entity to be created
+         * \param t_align the alignment of the memory, zero to align Arrays and DivSegs to their element size
          * \return a pointer to the created Entity object
          * \sa Entity, Table, Value, Array, DivSeg
          */
         Entity* request_memory(size_t t_amount,
                                size_t single_val,
                                Entity_ID e_id,
-                               const std::string& t_name) noexcept(false);
+                               const std::string& t_name,
+                               size_t t_align = 0) noexcept(false);
 
         //! \brief a method to get an Entity at the given index
         const Entity* get_entity(size_t index) const noexcept(false);
@@ -449,6 +1934,9 @@ namespace manager{
         //! \brief A dialogue method to list all Programs
         void list_programs();
 
+        //! \brief A dialogue method to compact the Table and report the memory moved
+        void compact();
+
         //! An obvious destructor deleting Programs and the Table pointers
         ~App();
     };
@@ -692,10 +2180,64 @@ namespace manager{
         * \param t_end the the end address of the range
         * \sa Entity
         */
-        std::vector<unsigned long long> operator ()(const Table& table,
+        virtual std::vector<unsigned long long> operator ()(const Table& table,
                 size_t t_begin,
                 size_t t_end) noexcept(false);
 
+        /*!
+         * \brief A method to read a run of the Array elements in one pass.
+         * \param table the table this Array is stored in
+         * \param t_begin the index of the first element
+         * \param t_count the amount of elements to read
+         * \param t_out the buffer of at least t_count numbers to read the elements to
+         * \note Throws std::out_of_range if the run exceeds the Array.
+         * \sa write_range(Table&, size_t, const unsigned long long*, size_t)
+         */
+        virtual void read_range(const Table& table,
+                size_t t_begin,
+                size_t t_count,
+                unsigned long long* t_out) const noexcept(false);
+
+        /*!
+         * \brief A method to write a run of the Array elements in one pass.
+         * \param table the table this Array is stored in
+         * \param t_begin the index of the first element
+         * \param t_in the t_count numbers to be written
+         * \param t_count the amount of elements to write
+         * \note Nothing is written if any of the numbers does not fit in an element.
+         * \sa read_range(const Table&, size_t, size_t, unsigned long long*)
+         */
+        virtual void write_range(Table& table,
+                size_t t_begin,
+                const unsigned long long* t_in,
+                size_t t_count) noexcept(false);
+
+        /*!
+         * \brief A method to set every element of the Array to the same value.
+         * \param table the table this Array is stored in
+         * \param what the value to be set
+         * \sa Table::fill(Unit, const std::vector<unsigned char>&)
+         */
+        void fill(Table& table, unsigned long long what) noexcept(false);
+
+        /*!
+         * \brief A method to copy the elements of another Array to the beginning of this one.
+         * \param table the table both Arrays are stored in
+         * \param src the Array to copy from, with elements of the same size and not more of them
+         * \sa Table::copy(Unit, Unit)
+         */
+        void copy_from(Table& table, const Array& src) noexcept(false);
+
+        /*!
+         * \brief A method to shift a run of elements inside the Array.
+         * \param table the table this Array is stored in
+         * \param t_from the index of the first element to move
+         * \param t_to the index to move it to
+         * \param t_count the amount of elements to move, the runs may overlap
+         * \sa Table::move(Unit, Unit)
+         */
+        void move_elements(Table& table, size_t t_from, size_t t_to, size_t t_count) noexcept(false);
+
         //! \brief A trivial destructor of the Array descriptor.
         ~Array() override = default;
     };
@@ -719,11 +2261,71 @@ namespace manager{
     class DivSeg : public Array{
     protected:
         std::vector<Program*> programs;    ///< The programs which have access to this Dividable Segment
-        std::mutex mtx;                     ///< The mutex object protecting from multitasking errors
+        mutable RW_mutex mtx;               ///< The lock shared by the readers and exclusive for the writers
+        std::atomic<size_t> version;        ///< The sequence counter, odd while a writer holds the lock
+        std::atomic<bool> optimistic;       ///< This field tells whether the reads skip the lock and check the version
+        std::mutex watch_mtx;               ///< The mutex the waiters for a change sleep on
+        std::condition_variable changed;    ///< A condition variable signalizing the elements have been written
+        std::atomic<size_t> watchers;       ///< The amount of waiters, the writers skip the notification without them
+        std::atomic<size_t> rmw_started;    ///< The amount of the hardware atomic updates begun, counted before the element is touched
+        std::atomic<size_t> rmw_done;       ///< The amount of the hardware atomic updates finished, counted after the element is touched
+        static const unsigned range_retries = 4;  ///< The amount of the lock-free range reads before the range is read under the exclusive lock
+        /*!
+         * \brief A method to apply an operation to an element atomically.
+         * \param table the table this Dividable Segment is stored in
+         * \param where the index of the element
+         * \param op the operation to be applied
+         * \param what the operand, cut to the size of the element
+         * \return the element before the operation
+         * \note The elements of 1, 2, 4 or 8 bytes at aligned addresses are updated by the hardware atomics
+         * under the shared lock, so that the updates run in parallel and only exclude the writers and the
+         * compaction, the readers load them with the hardware atomics as well. Every such update is counted
+         * in rmw_started and rmw_done, so the range reads notice it and read again. The other elements are
+         * updated under the exclusive lock.
+         * \sa load(const Table&, size_t), read_range(const Table&, size_t, size_t, unsigned long long*)
+         */
+        unsigned long long update(Table& table, size_t where, Atomic_op op, unsigned long long what) noexcept(false);
+
+        /*!
+         * \brief A method to find the element if the hardware atomics can work on it.
+         * \return the first byte of the element, nullptr if it must be updated under the exclusive lock
+         * \note The Dividable Segment must be locked.
+         */
+        unsigned char* atomic_element(Table& table, size_t where) const noexcept(false);
+
+        /*!
+         * \brief A method to tell whether the elements are of 1, 2, 4 or 8 bytes at aligned addresses.
+         * \return true if the hardware atomics work on the elements
+         */
+        bool atomic_width(const Table& table) const noexcept(false);
+
+        /*!
+         * \brief A method to read an element, with the hardware atomics if they work on it.
+         * \note The Dividable Segment must be locked shared at least, the updates may run meanwhile.
+         * \sa update(Table&, size_t, Atomic_op, unsigned long long)
+         */
+        unsigned long long load(const Table& table, size_t where) const noexcept(false);
+
+        /*!
+         * \brief A method to wait until an element satisfies a predicate.
+         * \param table the table this Dividable Segment is stored in
+         * \param where the index of the element
+         * \param pred the predicate on the element
+         * \param timed whether to stop waiting at the deadline
+         * \param deadline the time to stop waiting at
+         * \param value the element once the predicate holds, or the last one read
+         * \return true if the predicate holds, false if the deadline has passed
+         */
+        bool watch(Table& table,
+                size_t where,
+                const std::function<bool(unsigned long long)>& pred,
+                bool timed,
+                std::chrono::steady_clock::time_point deadline,
+                unsigned long long& value) noexcept(false);
     public:
 
         //! \brief The default trivial constructor of a Dividable Segment. Usually not used directly.
-        DivSeg() = default;
+        DivSeg() : version(0), optimistic(false), watchers(0), rmw_started(0), rmw_done(0) {};
 
         //! \brief A copying constructor of a Dividable Segment.
         DivSeg(const DivSeg&);
@@ -736,10 +2338,40 @@ namespace manager{
         * \param table the table this Dividable Segment stores the data in
         * \param t_index the index of the needed element of the Array
         * \return  the instance of a certain element
-        * \sa Entity
+        * \note In the optimistic mode the element is read without the lock and read again if a writer interfered.
+        * \sa Entity, set_optimistic_reads(bool)
         */
         unsigned long long get_single_instance(const Table& table, size_t t_index) noexcept(false);
 
+        /*!
+         * \brief A method to turn the lock-free optimistic reads on or off.
+         *
+         * The writers make the version odd while they hold the lock and even again
+         * once they leave, the reader takes the version, reads the element and
+         * retries if the version was odd or has changed since. The readers never
+         * write shared memory then, so they scale with the cores.
+         * \param t_optimistic whether the reads are optimistic
+         * \note Only the single element reads are optimistic, the ranges are always read under the lock.
+         */
+        void set_optimistic_reads(bool t_optimistic) { optimistic = t_optimistic; }
+
+        /*!
+         * \brief A method to make the queued writers go before new readers of this Dividable Segment.
+         * \param t_writer_preference whether the writers are preferred
+         * \note The readers are preferred by default, which serves the read-mostly segments best.
+         * \sa RW_mutex
+         */
+        void set_writer_preference(bool t_writer_preference) { mtx.set_writer_preference(t_writer_preference); }
+
+        /*!
+         * \brief A method to lock this Dividable Segment exclusively for writing or moving it in the Table.
+         * \note The version becomes odd, so the optimistic readers retry.
+         */
+        void lock() override;
+
+        //! \brief A method to unlock this Dividable Segment once it is written or moved, the version becomes even.
+        void unlock() override;
+
         /*!
         * \brief A method to set the instance of this Dividable Segment.
         * \param table the table this Dividable Segment is stored in
@@ -748,6 +2380,139 @@ namespace manager{
         */
         void set_single_instance(Table& table, size_t where, unsigned long long what) noexcept(false);
 
+        /*!
+         * \brief A method to add to an element atomically, wrapping around at the size of the element.
+         * \param table the table this Dividable Segment is stored in
+         * \param where the index of the element
+         * \param what the value to be added
+         * \return the element before the addition
+         * \sa update(Table&, size_t, Atomic_op, unsigned long long)
+         */
+        unsigned long long fetch_add(Table& table, size_t where, unsigned long long what) noexcept(false);
+
+        //! \brief A method to subtract from an element atomically, returning the element before.
+        unsigned long long fetch_sub(Table& table, size_t where, unsigned long long what) noexcept(false);
+
+        //! \brief A method to apply a bitwise and to an element atomically, returning the element before.
+        unsigned long long fetch_and(Table& table, size_t where, unsigned long long what) noexcept(false);
+
+        //! \brief A method to apply a bitwise or to an element atomically, returning the element before.
+        unsigned long long fetch_or(Table& table, size_t where, unsigned long long what) noexcept(false);
+
+        //! \brief A method to apply a bitwise xor to an element atomically, returning the element before.
+        unsigned long long fetch_xor(Table& table, size_t where, unsigned long long what) noexcept(false);
+
+        /*!
+         * \brief A method to replace an element atomically.
+         * \param table the table this Dividable Segment is stored in
+         * \param where the index of the element
+         * \param what the new instance to be set
+         * \return the element before the replacement
+         */
+        unsigned long long exchange(Table& table, size_t where, unsigned long long what) noexcept(false);
+
+        /*!
+         * \brief A method to replace an element atomically if it holds the expected value.
+         * \param table the table this Dividable Segment is stored in
+         * \param where the index of the element
+         * \param expected the value expected, set to the actual element if it differs
+         * \param desired the new instance to be set
+         * \return true if the element has been replaced
+         */
+        bool compare_exchange(Table& table,
+                size_t where,
+                unsigned long long& expected,
+                unsigned long long desired) noexcept(false);
+
+        /*!
+         * \brief The operator returning a consistent snapshot of the elements in the given range.
+         * \note The lock is taken shared once for the whole range, the snapshot is kept as by read_range().
+         * \sa Array::operator()(const Table&, size_t, size_t)
+         */
+        std::vector<unsigned long long> operator ()(const Table& table,
+                size_t t_begin,
+                size_t t_end) noexcept(false) override;
+
+        /*!
+         * \brief A method to read a consistent snapshot of a run of elements.
+         *
+         * The writers are excluded by the shared lock, but the hardware atomic
+         * updates run under it as well. The run is read again if any update
+         * was in progress meanwhile, and after range_retries attempts it is
+         * read under the exclusive lock, which waits for the updates to leave.
+         * The snapshot is the run at a single moment then: an update is seen
+         * either in all of the elements it touched before it or in none.
+         * \note The lock is taken shared once for the whole run, unless the updates keep interfering.
+         * \sa Array::read_range(const Table&, size_t, size_t, unsigned long long*)
+         */
+        void read_range(const Table& table,
+                size_t t_begin,
+                size_t t_count,
+                unsigned long long* t_out) const noexcept(false) override;
+
+        /*!
+         * \brief A method to write a run of elements at once for the readers.
+         * \note The lock is taken exclusively once for the whole run.
+         * \sa Array::write_range(Table&, size_t, const unsigned long long*, size_t)
+         */
+        void write_range(Table& table,
+                size_t t_begin,
+                const unsigned long long* t_in,
+                size_t t_count) noexcept(false) override;
+
+        /*!
+         * \brief A method to block until an element differs from the expected value.
+         * \param table the table this Dividable Segment is stored in
+         * \param where the index of the element
+         * \param expected the value the element is expected to leave
+         * \param t_wait the time to wait for the change
+         * \return true if the element has changed, false on timeout
+         * \note The waiter sleeps until a write wakes it, no polling is done.
+         * \sa notify()
+         */
+        bool wait_until_changed(Table& table,
+                size_t where,
+                unsigned long long expected,
+                std::chrono::microseconds t_wait) noexcept(false);
+
+        /*!
+         * \brief A method to block until an element satisfies a predicate.
+         * \param table the table this Dividable Segment is stored in
+         * \param where the index of the element
+         * \param pred the predicate on the element, called while the Dividable Segment is unlocked
+         * \return the element satisfying the predicate
+         * \sa notify()
+         */
+        unsigned long long wait_until(Table& table,
+                size_t where,
+                const std::function<bool(unsigned long long)>& pred) noexcept(false);
+
+        /*!
+         * \brief A method to wake the threads waiting for the elements to change.
+         * \note Every write through this Dividable Segment calls it, it is costless without waiters.
+         * \sa wait_until_changed(Table&, size_t, unsigned long long, std::chrono::microseconds)
+         */
+        void notify();
+
+        /*!
+         * \brief A method to set every element of this Dividable Segment under its lock.
+         * \sa Array::fill(Table&, unsigned long long)
+         */
+        void fill(Table& table, unsigned long long what) noexcept(false);
+
+        /*!
+         * \brief A method to copy the elements of another Array under the lock of this Dividable Segment.
+         * \note A Dividable Segment given as the source is locked as well.
+         * \sa Array::copy_from(Table&, const Array&)
+         */
+        void copy_from(Table& table, const Array& src) noexcept(false);
+
+        /*!
+         * \brief A method to shift a run of elements under the lock of this Dividable Segment.
+         * \sa Array::move_elements(Table&, size_t, size_t, size_t)
+         */
+        void move_elements(Table& table, size_t t_from, size_t t_to, size_t t_count) noexcept(false);
+
         /*!
          * \brief A method which shows all the information about this Dividable Segment.
          * \param table the table which this Dividable Segment is stored in
@@ -800,6 +2565,15 @@ namespace manager{
         ~DivSeg() override;
     };
 
+
+
+    template<typename T>
+    Elements<T> Entity::get_elements(Table& table) const noexcept(false) {
+        if(single_size != sizeof(T))
+            throw std::domain_error("the elements are of another size");
+        return Elements<T>(table.mutable_view(position.starter_address, position.size), table.get_order());
+    }
+
 }
 
 #endif //MEMORY_MANAGER_MANAGER_H
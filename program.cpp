@@ -45,19 +45,27 @@ namespace manager{
     Entity* Program::request_memory(size_t t_amount,
             size_t single_val,
             Entity_ID e_id,
-            const std::string& t_name) noexcept(false){
+            const std::string& t_name,
+            size_t t_align) noexcept(false){
 
         if(t_amount*single_val + memory_used() > memory_quota)
             throw std::runtime_error("memory quota reached for this program");
         if(single_val > sizeof(unsigned long long))
             throw std::domain_error("elements too big!");
 
+        if(t_align == 0)  // the elements are aligned to the biggest power of two dividing their size
+            t_align = e_id == Value_ID ? 1 : single_val & (~single_val + 1);
+
         Unit rc;
         Entity* ptr = nullptr;
         try{
-            rc = table->allocate_memory(t_amount*single_val);
+            if(e_id == Value_ID && t_amount == 1)
+                rc = table->allocate_slot(single_val, t_align);  // the Values share slab pages
+            else
+                rc = table->allocate_memory(t_amount*single_val, t_align);
             ptr = Entity::generate_Entity(e_id, single_val, t_name);
             ptr->set_pos(rc);
+            table->attach(ptr);
         }
         catch(...){
             throw;
@@ -76,6 +84,8 @@ namespace manager{
 
         entities.push_back(ent);
         ent->increment_refs();
+        if(ent->get_entity_id() == Link_ID)
+            table->attach(ent);  // the Links follow their Entities on compaction
         if(ent->get_entity_id() == DivSeg_ID){
             auto d_ptr = dynamic_cast<DivSeg*>(ent);
             d_ptr->add_program(this);
@@ -89,16 +99,23 @@ namespace manager{
         std::unique_lock<std::mutex> lock(mtx);
         not_empty.wait(lock, [this](){return !entities.empty(); });
 
-        Unit pos = entities.at(t_index)->get_pos();
+        if(t_index >= entities.size())
+            throw std::out_of_range("there is no such entity in the program");
         auto mark = entities.begin() + t_index;
+        Unit pos;
         (*mark)->decrement_refs();
         if((*mark)->get_entity_id() == DivSeg_ID){  // if it is a DivSeg don't forget
             auto d_ptr = dynamic_cast<DivSeg*>((*mark));   // to erase the link to this program
             d_ptr->erase_program(this);
         }
         if(!(*mark)->get_refs_count()){  // check whether entity is now free
+            bool owner = (*mark)->get_entity_id() != Link_ID;  // a Link does not own its memory
+            pos = table->detach(*mark);  // the compaction moves it no more
             delete (*mark);  // if it has no refs any more than delete it
-            table->mark_free(pos.starter_address, pos.size); // and mark as free
+            if(owner)
+                table->mark_free(pos.starter_address, pos.size); // and mark as free
+        } else{
+            pos = table->position_of(*mark);
         }
         entities.erase(mark); // delete from this programs entities anyway
         check_links(pos);
@@ -121,11 +138,12 @@ namespace manager{
     void Program::free_all_memory() noexcept {
         auto vec_it = entities.begin();
         for(; vec_it != entities.end(); ++vec_it){
-            Unit current_pos = (*vec_it)->get_pos();
             (*vec_it)->decrement_refs();
             if(!(*vec_it)->get_refs_count()){
+                Unit current_pos = table->detach(*vec_it);
                 try{
-                    table->mark_free(current_pos.starter_address, current_pos.size);
+                    if((*vec_it)->get_entity_id() != Link_ID)
+                        table->mark_free(current_pos.starter_address, current_pos.size);
                 } catch(...){ }
                 delete (*vec_it);
             }
@@ -149,6 +167,7 @@ namespace manager{
         auto it = program.entities.cbegin();  // this is a const iterator
         for(; it != program.entities.cend(); ++it){
             this->entities.push_back((*it)->clone());
+            table->attach(this->entities.back());
         }
         fptr[0] = nullptr;
         fptr[1] = &Program::d_create_entity;
@@ -311,7 +330,9 @@ namespace manager{
     int Program::d_show_all() {
         std::cout << "Entities amount: " << entities.size() << std::endl;
         std::cout << "Total memory used: " << memory_used() << std::endl;
-        std::cout << "Of memory quota: " << memory_quota << std::endl << std::endl;
+        std::cout << "Of memory quota: " << memory_quota << std::endl;
+        std::cout << "Free in the table: " << table->get_free()
+                  << " (biggest block " << table->get_largest_free() << ")" << std::endl << std::endl;
         show_all(std::cout);
         return 1;
     }
@@ -353,6 +374,7 @@ namespace manager{
         auto it = program.entities.cbegin();  // this is a const iterator
         for(; it != program.entities.cend(); ++it){
             this->entities.push_back((*it)->clone());
+            table->attach(this->entities.back());
         }
         fptr[0] = nullptr;
         fptr[1] = &Program::d_create_entity;
@@ -371,6 +393,7 @@ namespace manager{
         auto it = program.entities.cbegin();  // this is a const iterator
         for(; it != program.entities.cend(); ++it){
             this->entities.push_back((*it)->clone());
+            table->attach(this->entities.back());
         }
         fptr[0] = nullptr;
         fptr[1] = &Program::d_create_entity;
@@ -401,10 +424,11 @@ namespace manager{
         for(size_t i = 0; i < entities.size(); ++i){
             size_t sz = entities.size();
             if(entities.at(i)->get_entity_id() == Link_ID &&
-            guard == (entities.at(i)->get_pos())){
+            guard == table->position_of(entities.at(i))){
                 std::cerr << "Invalid Link: "
                               << entities.at(i)->get_name()
                               << std::endl;
+                table->detach(entities.at(i));
                 entities.erase(entities.begin() + i);
                 i = -1;
             }
@@ -0,0 +1,91 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+
+
+namespace manager{
+
+
+    RW_mutex::RW_mutex(bool t_writer_preference) : readers(0),
+                                                   writers_waiting(0),
+                                                   writing(false),
+                                                   writer_preference(t_writer_preference) {}
+
+
+
+    void RW_mutex::lock() {
+        std::unique_lock<std::mutex> lock(mtx);
+        ++writers_waiting;
+        writers.wait(lock, [this]() { return !writing && !readers; });
+        --writers_waiting;
+        writing = true;
+    }
+
+
+
+    bool RW_mutex::try_lock() {
+        std::unique_lock<std::mutex> lock(mtx);
+        if(writing || readers)
+            return false;
+        writing = true;
+        return true;
+    }
+
+
+
+    void RW_mutex::unlock() {
+        std::unique_lock<std::mutex> lock(mtx);
+        writing = false;
+        if(writer_preference && writers_waiting){  // the readers wait for the queued writers anyway
+            writers.notify_one();
+            return;
+        }
+        readers_ready.notify_all();
+        writers.notify_one();
+    }
+
+
+
+    void RW_mutex::lock_shared() {
+        std::unique_lock<std::mutex> lock(mtx);
+        readers_ready.wait(lock, [this]() { return readable(); });
+        ++readers;
+    }
+
+
+
+    bool RW_mutex::try_lock_shared() {
+        std::unique_lock<std::mutex> lock(mtx);
+        if(!readable())
+            return false;
+        ++readers;
+        return true;
+    }
+
+
+
+    void RW_mutex::unlock_shared() {
+        std::unique_lock<std::mutex> lock(mtx);
+        if(!--readers)
+            writers.notify_one();
+    }
+
+
+
+    void RW_mutex::set_writer_preference(bool t_writer_preference) {
+        std::unique_lock<std::mutex> lock(mtx);
+        writer_preference = t_writer_preference;
+        readers_ready.notify_all();  // the readers held back by the queued writers may go now
+    }
+
+
+
+    bool RW_mutex::get_writer_preference() const {
+        std::unique_lock<std::mutex> lock(mtx);
+        return writer_preference;
+    }
+
+
+}
@@ -8,127 +8,1013 @@
 namespace manager{
 
 
-    Table::Table() {
-        memory.insert(memory.begin(), max_size, '\0');
-        free_blocks = {};
-        Unit un(0, max_size);
-        free_blocks.push_back(un);
+    std::mutex Table::live_mtx;
+    std::unordered_map<size_t, Table*> Table::live;
+    std::atomic<size_t> Table::serials(0);
+    thread_local Table::Thread_cache Table::cache;
+
+
+
+    /*!
+     * \brief A function to find the first free slot of a slab page.
+     * \return the index of the lowest set bit of the bitmap, which must not be zero
+     */
+    static size_t lowest_slot(unsigned long long t_slots) noexcept {
+#if defined(__GNUC__)
+        return static_cast<size_t>(__builtin_ctzll(t_slots));
+#else
+        size_t k = 0;
+        while(!(t_slots & 1)){
+            t_slots >>= 1;
+            ++k;
+        }
+        return k;
+#endif
+    }
+
+
+
+    Table::Table(size_t t_capacity,
+            size_t t_limit,
+            Alloc_ID t_engine,
+            Byte_order t_order,
+            size_t t_arenas) noexcept(false) :
+            Table(t_capacity,
+                  t_limit,
+                  [t_engine](Unit un) -> Allocator* { return Allocator::generate_Allocator(t_engine, un); },
+                  t_order,
+                  t_arenas) {}
+
+
+
+    Table::Table(size_t t_capacity,
+            size_t t_limit,
+            const std::function<Allocator*(Unit)>& t_factory,
+            Byte_order t_order,
+            size_t t_arenas) noexcept(false) :
+            capacity(t_capacity),
+            free_bytes(t_capacity),
+            used_bytes(0),
+            limit(std::max(t_capacity, t_limit)),
+            order(t_order),
+            range_count(0),
+            sweep(0),
+            serial(serials++),
+            cached_bytes(0),
+            queued(0),
+            slab_count(0) {
+        if(t_capacity == 0)
+            throw std::invalid_argument("table capacity is zero");
+        if(t_arenas == 0 || t_arenas > t_capacity)
+            throw std::invalid_argument("every arena needs some memory");
+        memory.reserve(limit);  // the memory must never move when it grows
+        memory.insert(memory.begin(), t_capacity, '\0');
+        ranges.reserve(t_arenas + sizeof(size_t)*8 + 1);  // nor may the ranges, they are read with no lock
+        size_t share = t_capacity / t_arenas;
+        try{
+            for(size_t i = 0; i < t_arenas; ++i){
+                size_t strt = i*share;
+                Allocator* engine = t_factory(Unit(strt, i + 1 == t_arenas ? t_capacity - strt : share));
+                if(!engine)
+                    throw std::invalid_argument("the engine factory gave no engine");
+                arenas.push_back(new Arena(engine));
+                ranges.emplace_back(strt, i);
+            }
+        }
+        catch(...){  // the destructor is not called for a Table never constructed
+            for(auto arena : arenas){
+                delete arena;
+            }
+            throw;
+        }
+        range_count = ranges.size();
+        free_bytes = 0;
+        for(auto arena : arenas){
+            free_bytes += arena->engine->free_size();
+        }
+
+        std::lock_guard<std::mutex> lock(live_mtx);
+        live[serial] = this;
+    }
+
+
+
+    Table::~Table() {
+        {
+            std::lock_guard<std::mutex> lock(live_mtx);  // the exiting threads no longer return blocks here
+            live.erase(serial);
+        }
+        cache.tables.erase(serial);
+        for(auto arena : arenas){
+            delete arena;
+        }
+    }
+
+
+
+    Table::Thread_cache::~Thread_cache() {
+        std::lock_guard<std::mutex> lock(live_mtx);
+        for(auto& entry : tables){
+            auto mark = live.find(entry.first);
+            if(mark == live.end())
+                continue;  // the Table is gone together with its memory
+            Table* table = mark->second;
+            {
+                std::lock_guard<std::mutex> cache_lock(table->cache_mtx);
+                auto& caches = table->caches;
+                caches.erase(std::remove(caches.begin(), caches.end(), &entry.second), caches.end());
+            }
+            table->drain(entry.second);
+            if(table->queued){
+                std::unique_lock<std::mutex> table_lock(table->mtx);
+                table->serve_waiters();
+            }
+        }
+    }
+
+
+
+    Table::Magazines& Table::magazines() {
+        auto mark = cache.tables.find(serial);
+        if(mark != cache.tables.end())
+            return mark->second;
+
+        Magazines& mags = cache.tables[serial];
+        std::lock_guard<std::mutex> lock(cache_mtx);  // the other threads may reclaim the blocks from now on
+        caches.push_back(&mags);
+        return mags;
+    }
+
+
+
+    Unit Table::pop_cached(size_t t_size, size_t t_align) {
+        Magazines& mags = magazines();
+        std::lock_guard<std::mutex> mags_lock(mags.mtx);
+        auto& blocks = mags.blocks[t_size];
+        auto mark = std::find_if(blocks.rbegin(),
+                                 blocks.rend(),
+                                 [t_align](size_t strt) -> bool { return !(strt & (t_align - 1)); });
+        if(mark == blocks.rend())
+            return {};
+
+        size_t strt = *mark;
+        blocks.erase(std::next(mark).base());
+        reuse(strt);
+        if(t_align > 1){
+            std::lock_guard<std::mutex> lock(meta_mtx);
+            size_t& align = alignments[strt];
+            align = std::max(align, t_align);  // a stale bigger alignment only costs some padding
+        }
+        mags.bytes -= t_size;
+        cached_bytes -= t_size;
+        used_bytes += t_size;
+        return {strt, t_size};
+    }
+
+
+
+    bool Table::push_cached(size_t t_strt, size_t t_size) noexcept(false) {
+        if(t_size > magazine_size)
+            return false;
+
+        Magazines& mags = magazines();
+        std::lock_guard<std::mutex> mags_lock(mags.mtx);
+        if(queued)  // checked under the lock, so a waiter reclaiming the caches sees the block
+            return false;
+        auto& blocks = mags.blocks[t_size];
+        if(blocks.size() == magazine_capacity){  // the older half is shared with the other threads again
+            std::vector<size_t> surplus(blocks.begin(), blocks.begin() + magazine_capacity/2);
+            blocks.erase(blocks.begin(), blocks.begin() + magazine_capacity/2);
+            mags.bytes -= surplus.size() * t_size;
+            release_cached(t_size, surplus);
+        }
+        if(mags.bytes + t_size > magazine_bytes)
+            return false;
+        claim(t_strt, t_size, true);
+        blocks.push_back(t_strt);
+        mags.bytes += t_size;
+        cached_bytes += t_size;
+        used_bytes -= t_size;
+        return true;
+    }
+
+
+
+    void Table::release_cached(size_t t_size, const std::vector<size_t>& t_blocks) {
+        if(t_blocks.empty())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(meta_mtx);
+            for(size_t strt : t_blocks){
+                alignments.erase(strt);
+            }
+        }
+        for(size_t strt : t_blocks){
+            forget(strt);
+            release_to(Unit(strt, t_size));
+            cached_bytes -= t_size;
+        }
+    }
+
+
+
+    void Table::drain(Magazines& mags) {
+        std::lock_guard<std::mutex> mags_lock(mags.mtx);
+        for(size_t sz = 1; sz <= magazine_size; ++sz){
+            std::vector<size_t> blocks;
+            blocks.swap(mags.blocks[sz]);
+            release_cached(sz, blocks);
+        }
+        mags.bytes = 0;
+    }
+
+
+
+    void Table::reclaim() {
+        {
+            std::lock_guard<std::mutex> cache_lock(cache_mtx);
+            for(auto mags : caches){
+                drain(*mags);
+            }
+        }
+        serve_waiters();
+    }
+
+
+
+    void Table::flush_cache() {
+        std::unique_lock<std::mutex> lock(mtx);
+        drain(magazines());
+        serve_waiters();
+    }
+
+
+
+    size_t Table::home_arena() const {
+        return std::hash<std::thread::id>()(std::this_thread::get_id()) % arenas.size();
+    }
+
+
+
+    size_t Table::arena_of(size_t t_strt) const {
+        auto end = ranges.begin() + range_count.load(std::memory_order_acquire);
+        auto mark = std::upper_bound(ranges.begin(),
+                                     end,
+                                     t_strt,
+                                     [](size_t strt, const std::pair<size_t, size_t>& range) -> bool {
+                                         return strt < range.first;
+                                     });
+        return std::prev(mark)->second;
+    }
+
+
+
+    std::vector<std::pair<size_t, Unit>> Table::split(Unit un) const {
+        std::vector<std::pair<size_t, Unit>> parts;
+        size_t count = range_count.load(std::memory_order_acquire);
+        size_t end = un.starter_address + un.size;
+        for(size_t i = 0; i < count && un.starter_address < end; ++i){
+            size_t range_end = i + 1 < count ? ranges[i + 1].first : size_t(capacity);
+            if(range_end <= un.starter_address)
+                continue;
+            size_t part_end = std::min(end, range_end);
+            parts.emplace_back(ranges[i].second, Unit(un.starter_address, part_end - un.starter_address));
+            un.starter_address = part_end;
+        }
+        return parts;
+    }
+
+
+
+    bool Table::grow(size_t t_size, size_t t_arena, size_t t_seen) {
+        std::unique_lock<std::mutex> lock(grow_mtx);
+        size_t old_size = capacity;
+        if(old_size != t_seen)
+            return true;  // another thread has grown the memory meanwhile
+        if(old_size == limit)
+            return false;
+
+        size_t new_size = old_size + std::max(old_size, t_size);
+        if(new_size > limit || new_size < old_size)
+            new_size = limit;  // the free tail may still make the block fit
+        memory.resize(new_size, '\0');
+        if(ranges.back().second != t_arena){
+            ranges.emplace_back(old_size, t_arena);
+            range_count.store(ranges.size(), std::memory_order_release);
+        }
+        capacity = new_size;
+
+        Arena* arena = arenas[t_arena];
+        std::lock_guard<std::mutex> arena_lock(arena->mtx);
+        size_t before = arena->engine->free_size();
+        arena->engine->extend(Unit(old_size, new_size - old_size));
+        free_bytes += arena->engine->free_size() - before;
+        arena->largest = arena->engine->largest_free();
+        return true;
     }
 
 
 
     void Table::defragmentation() {
-        std::vector<Unit>::iterator vec_it;  // a cycle is used for full defragmentation
-        for(vec_it = free_blocks.begin() + 1; vec_it != free_blocks.end(); ++vec_it){
-            if(vec_it->starter_address == (vec_it - 1)->starter_address + (vec_it - 1)->size + 1){
-                --vec_it;
-                size_t sz = (vec_it + 1)->size;  //guaranteed not to fail bc of --vec_it
-                free_blocks.erase(vec_it + 1);
-                vec_it->size += sz;
+        for(auto arena : arenas){
+            std::lock_guard<std::mutex> lock(arena->mtx);
+            arena->engine->defragmentation();
+            arena->largest = arena->engine->largest_free();
+        }
+    }
+
+
+
+    void Table::set_policy(Fit_ID t_policy) noexcept(false) {
+        set_policy([t_policy]() -> Fit_policy* { return Fit_policy::generate_Fit_policy(t_policy); });
+    }
+
+
+
+    void Table::set_policy(const std::function<Fit_policy*()>& t_factory) noexcept(false) {
+        for(auto arena : arenas){
+            std::lock_guard<std::mutex> lock(arena->mtx);
+            arena->engine->set_policy(t_factory());
+        }
+    }
+
+
+
+    bool Table::movable() const {
+        return std::all_of(arenas.begin(), arenas.end(), [](Arena* arena) -> bool { return arena->engine->movable(); });
+    }
+
+
+
+    void Table::attach(Entity* ent) {
+        size_t strt = ent->get_pos().starter_address;
+        if(slab_count){
+            std::lock_guard<std::mutex> slab_lock(slab_mtx);
+            if(slab_of(strt) != slabs.end())
+                return;  // the slab pages stay in place
+        }
+        std::unique_lock<std::mutex> lock(meta_mtx);
+        residents[ent->get_pos().starter_address].push_back(ent);  // a Link's Entity may have moved meanwhile
+    }
+
+
+
+    Unit Table::detach(Entity* ent) {
+        std::unique_lock<std::mutex> lock(meta_mtx);
+        Unit pos = ent->get_pos();
+        auto mark = residents.find(pos.starter_address);
+        if(mark == residents.end())
+            return pos;
+        auto& group = mark->second;
+        if(ent->get_entity_id() != Link_ID){  // the Links of a freed block must not be moved as a block
+            residents.erase(mark);
+            return pos;
+        }
+        group.erase(std::remove(group.begin(), group.end(), ent), group.end());
+        if(group.empty())
+            residents.erase(mark);
+        return pos;
+    }
+
+
+
+    Unit Table::position_of(const Entity* ent) {
+        std::unique_lock<std::mutex> lock(meta_mtx);
+        return ent->get_pos();
+    }
+
+
+
+    void Table::relocate(std::vector<Entity*>& group, size_t t_strt) {
+        size_t sz = group.front()->get_size();
+        for(auto ent : group){
+            ent->lock();
+        }
+        std::memmove(memory.data() + t_strt, memory.data() + group.front()->get_pos().starter_address, sz);
+        for(auto ent : group){
+            ent->move_to(t_strt);
+        }
+        for(auto ent = group.rbegin(); ent != group.rend(); ++ent){
+            (*ent)->unlock();
+        }
+    }
+
+
+
+    Compaction Table::compact() noexcept(false) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if(!movable())
+            throw std::domain_error("the allocation engine cannot move blocks");
+
+        auto begin = std::chrono::steady_clock::now();
+        reclaim();  // the cached blocks are holes to be filled
+        std::unique_lock<std::mutex> grow_lock(grow_mtx);
+        std::vector<std::unique_lock<std::mutex>> arena_locks;
+        for(auto arena : arenas){
+            arena_locks.emplace_back(arena->mtx);
+        }
+        std::unique_lock<std::mutex> meta_lock(meta_mtx);
+
+        Compaction report;
+        std::vector<Unit> holes;
+        for(auto arena : arenas){
+            std::vector<Unit> blocks = arena->engine->get_free_blocks();
+            holes.insert(holes.end(), blocks.begin(), blocks.end());
+        }
+        std::sort(holes.begin(),
+                  holes.end(),
+                  [](Unit a, Unit b) -> bool { return a.starter_address < b.starter_address; });
+        std::vector<size_t> borders;  // the blocks never cross into another arena
+        for(size_t i = 1; i < range_count; ++i){
+            if(ranges[i].second != ranges[i - 1].second)
+                borders.push_back(ranges[i].first);
+        }
+        std::vector<Unit> free_after;                               // the free memory once compacted
+        std::map<size_t, std::vector<Entity*>> moved_residents;     // the residents at their new addresses
+        std::map<size_t, size_t> moved_alignments;                  // their alignments at the new addresses
+        size_t cursor = 0;  // where the next live block goes
+        size_t addr = 0;    // where the walk through the memory is
+        auto hole = holes.begin();
+        auto res = residents.begin();
+        auto border = borders.begin();
+        auto pass_borders = [&]() {  // the cursor starts anew in every arena
+            for(; border != borders.end() && *border <= addr; ++border){
+                if(cursor < *border){
+                    free_after.emplace_back(cursor, *border - cursor);
+                    cursor = *border;
+                }
+            }
+        };
+
+        while(addr < capacity){
+            pass_borders();
+            if(hole != holes.end() && hole->starter_address <= addr){  // free memory is skipped
+                addr = std::max(addr, hole->starter_address + hole->size);
+                ++hole;
+                continue;
+            }
+            size_t run_end = hole != holes.end() ? hole->starter_address : size_t(capacity);
+            while(addr < run_end){  // the allocated run up to the next hole
+                pass_borders();
+                while(res != residents.end() && res->first < addr)
+                    ++res;  // a resident inside a hole or a block cannot be moved
+                if(res != residents.end() && res->first == addr){
+                    size_t sz = res->second.front()->get_size();
+                    size_t align = alignment_of(addr);
+                    size_t dst = Allocator::align_up(cursor, align);  // never past addr, which is aligned
+                    if(dst > cursor)
+                        free_after.emplace_back(cursor, dst - cursor);
+                    if(dst != addr){
+                        relocate(res->second, dst);
+                        rekey(addr, dst);
+                        report.bytes_moved += sz;
+                        ++report.entities_moved;
+                    }
+                    if(align > 1)
+                        moved_alignments[dst] = align;
+                    moved_residents[dst] = std::move(res->second);
+                    cursor = dst + sz;
+                    addr += sz;
+                    ++res;
+                } else{  // memory allocated past the Entities is pinned
+                    size_t pin_end = (res != residents.end() && res->first < run_end) ? res->first : run_end;
+                    if(cursor < addr)
+                        free_after.emplace_back(cursor, addr - cursor);
+                    for(auto pin = alignments.lower_bound(addr); pin != alignments.end() && pin->first < pin_end; ++pin){
+                        moved_alignments.insert(*pin);
+                    }
+                    cursor = pin_end;
+                    addr = pin_end;
+                }
+            }
+        }
+        pass_borders();
+        if(cursor < capacity)
+            free_after.emplace_back(cursor, capacity - cursor);
+
+        residents = std::move(moved_residents);
+        alignments = std::move(moved_alignments);
+        for(auto arena : arenas){
+            arena->engine->clear();
+        }
+        for(auto& block : free_after){
+            arenas[arena_of(block.starter_address)]->engine->extend(block);
+        }
+        size_t total = 0;
+        for(auto arena : arenas){
+            total += arena->engine->free_size();
+            arena->largest = arena->engine->largest_free();
+        }
+        free_bytes = total;
+        sweep = 0;
+        meta_lock.unlock();
+        arena_locks.clear();
+        grow_lock.unlock();
+
+        report.pause = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin);
+        serve_waiters();
+        return report;
+    }
+
+
+
+    Compaction Table::compact_step(size_t t_bytes, std::chrono::microseconds t_pause) noexcept(false) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if(!movable())
+            throw std::domain_error("the allocation engine cannot move blocks");
+
+        auto begin = std::chrono::steady_clock::now();
+        if(cached_bytes)
+            reclaim();  // the cached blocks are holes to be filled
+        std::unique_lock<std::mutex> grow_lock(grow_mtx);
+        std::vector<std::unique_lock<std::mutex>> arena_locks;
+        for(auto arena : arenas){
+            arena_locks.emplace_back(arena->mtx);
+        }
+        std::unique_lock<std::mutex> meta_lock(meta_mtx);
+        Compaction report;
+        size_t prev_end = sweep;  // the end of the previous resident
+        auto res = residents.lower_bound(sweep);
+
+        while(res != residents.end() && report.bytes_moved < t_bytes &&
+              std::chrono::steady_clock::now() - begin < t_pause){
+            size_t addr = res->first;
+            size_t sz = res->second.front()->get_size();
+            size_t align = alignment_of(addr);
+            size_t dst = Allocator::align_up(prev_end, align);
+            size_t home = addr > dst ? arena_of(prev_end) : 0;
+            if(addr > dst && sz <= t_bytes && report.bytes_moved + sz > t_bytes)
+                break;  // the budget is spent, the next step goes on from here
+            if(addr > dst && sz <= t_bytes &&
+               (home == arena_of(addr) || dst + sz <= addr) &&  // the block may not cross into another arena
+               arenas[home]->engine->take(Unit(prev_end, addr - prev_end))){  // only a single free hole may be filled
+                relocate(res->second, dst);
+                rekey(addr, dst);
+                if(dst > prev_end)
+                    arenas[home]->engine->release(Unit(prev_end, dst - prev_end));  // the padding stays free
+                for(auto& part : split(Unit(dst + sz, addr - dst))){
+                    arenas[part.first]->engine->release(part.second);
+                }
+                if(align > 1){
+                    alignments.erase(addr);
+                    alignments[dst] = align;
+                }
+                residents[dst] = std::move(res->second);
+                residents.erase(res);
+                res = residents.find(dst);
+                report.bytes_moved += sz;
+                ++report.entities_moved;
             }
+            prev_end = res->first + sz;
+            ++res;
+        }
+        sweep = res == residents.end() ? 0 : prev_end;
+        size_t total = 0;
+        for(auto arena : arenas){
+            total += arena->engine->free_size();
+            arena->largest = arena->engine->largest_free();
         }
+        free_bytes = total;
+        meta_lock.unlock();
+        arena_locks.clear();
+        grow_lock.unlock();
+
+        report.pause = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin);
+        if(report.entities_moved)
+            serve_waiters();
+        return report;
     }
 
 
 
     void Table::mark_free(size_t t_strt, size_t t_size) noexcept(false) {
-        std::unique_lock<std::mutex> lock(mtx);
-        not_empty.wait(lock, [this]() {
-            size_t count = 0;
-            for(auto& block : free_blocks){
-                count += block.size;
+        if(t_strt > capacity)
+            throw std::out_of_range("starter address higher than table capacity");
+        if(t_size > capacity - t_strt)
+            throw std::out_of_range("freed block exceeds table capacity");
+        if(t_size && slab_count && free_slot(t_strt, t_size))
+            return;
+        if(t_size && push_cached(t_strt, t_size))
+            return;
+        claim(t_strt, t_size, false);
+
+        if(!used_bytes){
+            std::unique_lock<std::mutex> lock(empty_mtx);
+            not_empty.wait(lock, [this]() { return used_bytes != 0; });
+        }
+        {
+            std::lock_guard<std::mutex> meta_lock(meta_mtx);
+            alignments.erase(t_strt);  // before the block may be taken again
+        }
+        release_to(Unit(t_strt, t_size));
+        used_bytes -= t_size;
+
+        if(queued){  // the waiters count themselves before their last try, so none is missed
+            std::unique_lock<std::mutex> lock(mtx);
+            serve_waiters();
+        }
+    }
+
+
+
+    Unit Table::take_from(Arena* arena, size_t t_size, size_t t_align) {
+        std::lock_guard<std::mutex> lock(arena->mtx);
+        size_t before = arena->engine->free_size();
+        Unit pos = arena->engine->allocate(t_size, t_align);
+        free_bytes -= before - arena->engine->free_size();
+        if(pos.size)
+            arena->largest = arena->engine->largest_free();
+        return pos;
+    }
+
+
+
+    void Table::release_to(Unit un) noexcept(false) {
+        Arena* arena = arenas[arena_of(un.starter_address)];
+        std::lock_guard<std::mutex> lock(arena->mtx);
+        size_t before = arena->engine->free_size();
+        arena->engine->release(un);
+        free_bytes += arena->engine->free_size() - before;
+        arena->largest = arena->engine->largest_free();
+    }
+
+
+
+    Unit Table::take_memory(size_t t_size, size_t t_align) {
+        size_t home = home_arena();
+        Unit pos;
+        for(;;){
+            size_t seen = capacity;
+            for(size_t i = 0; i < arenas.size() && !pos.size; ++i){  // the neighbours once the own arena is exhausted
+                pos = take_from(arenas[(home + i) % arenas.size()], t_size, t_align);
             }
-            return count != max_size;
-        });
+            if(pos.size || !grow(t_size + t_align - 1, home, seen))  // the engine may need more, e.g. for the rounding
+                break;
+        }
+        if(pos.size){
+            record(pos);
+            if(t_align > 1){
+                std::lock_guard<std::mutex> lock(meta_mtx);
+                alignments[pos.starter_address] = t_align;
+            }
+            if(!used_bytes.fetch_add(pos.size)){
+                std::lock_guard<std::mutex> lock(empty_mtx);
+                not_empty.notify_all();
+            }
+        }
+        return pos;
+    }
+
+
+
+    void Table::record(Unit un) {
+        Record& part = record_of(un.starter_address);
+        std::lock_guard<std::mutex> lock(part.mtx);
+        part.blocks[un.starter_address] = std::make_pair(un.size, false);
+    }
+
+
+
+    void Table::claim(size_t t_strt, size_t t_size, bool t_cache) noexcept(false) {
+        Record& part = record_of(t_strt);
+        std::lock_guard<std::mutex> lock(part.mtx);
+        auto mark = part.blocks.find(t_strt);
+        if(mark == part.blocks.end())
+            throw std::invalid_argument("attempt to free memory which is not allocated");
+        if(mark->second.second)
+            throw std::invalid_argument("attempt to free memory which is already free");
+        if(mark->second.first != t_size)
+            throw std::invalid_argument("freed block does not match its allocation");
+        if(t_cache)
+            mark->second.second = true;
+        else
+            part.blocks.erase(mark);
+    }
+
+
+
+    void Table::reuse(size_t t_strt) {
+        Record& part = record_of(t_strt);
+        std::lock_guard<std::mutex> lock(part.mtx);
+        part.blocks[t_strt].second = false;
+    }
+
+
+
+    void Table::forget(size_t t_strt) {
+        Record& part = record_of(t_strt);
+        std::lock_guard<std::mutex> lock(part.mtx);
+        part.blocks.erase(t_strt);
+    }
 
-        if(t_strt < 0)
-            throw std::out_of_range("starter address below zero");
-        if(t_strt > max_size)
-            throw std::out_of_range("starter address higher than max size");
 
-        auto vec_it = free_blocks.begin();
-        for(; vec_it != free_blocks.end(); ++vec_it){  // checks for invalid
-            size_t current_start = vec_it->starter_address;
-            size_t current_end = vec_it->starter_address + vec_it->size;
 
-            if(current_start <= t_strt && current_end >= t_strt)
-                throw std::invalid_argument("attempt to free memory with start before or at arg");
-            if(current_start > t_strt && current_end < t_strt + t_size)
-                throw std::invalid_argument("attempt to free memory with end after or at arg");
+    void Table::rekey(size_t t_from, size_t t_to) {
+        std::pair<size_t, bool> block;
+        {
+            Record& part = record_of(t_from);
+            std::lock_guard<std::mutex> lock(part.mtx);
+            auto mark = part.blocks.find(t_from);
+            if(mark == part.blocks.end())
+                return;  // a resident not allocated by the Table, such as a slab slot
+            block = mark->second;
+            part.blocks.erase(mark);
         }
+        Record& part = record_of(t_to);
+        std::lock_guard<std::mutex> lock(part.mtx);
+        part.blocks[t_to] = block;
+    }
+
 
-        auto mark = std::find_if(free_blocks.begin(),
-                                 free_blocks.end(),
-                                 [t_strt](Unit un) -> bool { return un.starter_address > t_strt; });
-        Unit newcomer(t_strt, t_size);
-        free_blocks.insert(mark, newcomer);
 
-        not_full.notify_one();
+    size_t Table::alignment_of(size_t t_strt) const {
+        auto mark = alignments.find(t_strt);
+        return mark == alignments.end() ? 1 : mark->second;
     }
 
 
 
-    Unit Table::allocate_memory(size_t t_size) noexcept(false) {
-        std::unique_lock<std::mutex> lock(mtx);
-        not_full.wait(lock, [this](){
-            size_t count = 0;
-            for(auto& block : free_blocks){
-                count += block.size;
+    std::map<size_t, Table::Slab>::iterator Table::slab_of(size_t t_strt) {
+        auto mark = slabs.upper_bound(t_strt);
+        if(mark == slabs.begin())
+            return slabs.end();
+        --mark;
+        const Unit& page = mark->second.page;
+        return t_strt < page.starter_address + page.size ? mark : slabs.end();
+    }
+
+
+
+    bool Table::free_slot(size_t t_strt, size_t t_size) noexcept(false) {
+        std::unique_lock<std::mutex> lock(slab_mtx);
+        auto mark = slab_of(t_strt);
+        if(mark == slabs.end())
+            return false;
+
+        Slab& slab = mark->second;
+        size_t offset = t_strt - mark->first;
+        if(t_size != slab.width || offset % slab.width || offset / slab.width >= slab_slots)
+            throw std::invalid_argument("freed block is not a slot of its slab page");
+        unsigned long long bit = 1ULL << (offset / slab.width);
+        if(slab.free_slots & bit)
+            throw std::invalid_argument("attempt to free memory which is already free");
+        if(!slab.free_slots)
+            partial[slab.width].insert(mark->first);
+        slab.free_slots |= bit;
+        if(~slab.free_slots)
+            return true;
+
+        Unit page = slab.page;  // the page is empty, so it goes back to its arena
+        partial[slab.width].erase(mark->first);
+        slabs.erase(mark);
+        --slab_count;
+        forget(page.starter_address);
+        {
+            std::lock_guard<std::mutex> meta_lock(meta_mtx);
+            alignments.erase(page.starter_address);  // before the page may be taken again
+        }
+        release_to(page);
+        used_bytes -= page.size;
+        lock.unlock();
+
+        if(queued){
+            std::unique_lock<std::mutex> table_lock(mtx);
+            serve_waiters();
+        }
+        return true;
+    }
+
+
+
+    Unit Table::allocate_slot(size_t t_size, size_t t_align) noexcept(false) {
+        size_t natural = t_size & (~t_size + 1);  // the alignment all the slots of the width have
+        if(t_size == 0 || t_size > slab_width || t_align == 0 || natural % t_align)
+            return allocate_memory(t_size, t_align);
+
+        std::unique_lock<std::mutex> lock(slab_mtx);
+        auto& pages = partial[t_size];
+        if(pages.empty()){
+            Unit page = take_memory(t_size*slab_slots, natural);
+            if(!page.size){  // the slab does not wait for a page, a single slot may still fit
+                lock.unlock();
+                return allocate_memory(t_size, t_align);
             }
-            return count > 1;
-        });
+            slabs.emplace(page.starter_address, Slab(page, t_size));
+            pages.insert(page.starter_address);
+            ++slab_count;
+        }
+
+        size_t strt = *pages.begin();
+        Slab& slab = slabs.at(strt);
+        size_t slot = lowest_slot(slab.free_slots);
+        slab.free_slots &= slab.free_slots - 1;
+        if(!slab.free_slots)
+            pages.erase(pages.begin());
+        return {strt + slot*t_size, t_size};
+    }
+
 
-        auto mark = std::find_if(free_blocks.begin(),
-                                 free_blocks.end(),
-                                 [t_size](Unit un) -> bool { return un.size >= t_size; });
 
-        if(mark == free_blocks.end()){
-            defragmentation();
-            mark = std::find_if(free_blocks.begin(),
-                                free_blocks.end(),
-                                [t_size](Unit un) -> bool { return un.size >= t_size; });
-            if(mark == free_blocks.end()) throw std::runtime_error("not enough memory");
+    size_t Table::largest_free() const noexcept {
+        size_t largest = 0;
+        for(auto arena : arenas){
+            largest = std::max(largest, arena->largest.load());
         }
+        return largest;
+    }
+
+
+
+    void Table::serve_waiters() {
+        auto mark = waiters.begin();
+        size_t largest = largest_free();  // only the allocations below make it smaller
+        while(mark != waiters.end() && free_bytes){
+            Waiter* waiter = *mark;
+            Unit pos;
+            if(waiter->size <= largest)
+                pos = take_memory(waiter->size, waiter->align);
+            if(!pos.size){  // the later waiters may still fit
+                ++mark;
+                continue;
+            }
+            largest = largest_free();
+            waiter->result = pos;
+            waiter->done = true;
+            mark = waiters.erase(mark);
+            waiter->ready.notify_one();
+        }
+    }
+
+
+
+    size_t Table::biggest_block() {
+        std::lock_guard<std::mutex> lock(grow_mtx);
+        size_t biggest = limit - ranges.back().first;  // the memory grows on past the last range
+        for(size_t i = 0; i + 1 < ranges.size(); ++i){
+            biggest = std::max(biggest, ranges[i + 1].first - ranges[i].first);
+        }
+        return biggest;
+    }
 
-        size_t strt = mark->starter_address;
 
-        if(mark->size == t_size){
-            free_blocks.erase(mark);
+
+    Unit Table::wait_memory(size_t t_size,
+            size_t t_align,
+            bool timed,
+            std::chrono::steady_clock::time_point deadline) noexcept(false) {
+        if(t_size == 0)
+            throw std::invalid_argument("attempt to allocate an empty block");
+        if(t_align == 0 || (t_align & (t_align - 1)) || t_align > limit)
+            throw std::invalid_argument("alignment is not a power of two within the limit");
+        if(t_size > limit)
+            throw std::runtime_error("not enough memory");
+
+        Unit pos;
+        if(t_size <= magazine_size && (pos = pop_cached(t_size, t_align)).size)
+            return pos;
+        if((pos = take_memory(t_size, t_align)).size)
+            return pos;
+
+        std::unique_lock<std::mutex> lock(mtx);
+        ++queued;  // the frees from now on serve the queue and skip the caches
+        if(cached_bytes)
+            reclaim();  // the blocks kept by any thread may fit once merged
+        pos = take_memory(t_size, t_align);
+        if(pos.size || !used_bytes || t_size > biggest_block()){
+            --queued;
+            if(!pos.size)  // nothing is to be freed, or no arena may hold it, so waiting is pointless
+                throw std::runtime_error("not enough memory");
+            return pos;
+        }
+
+        Waiter waiter(t_size, t_align);
+        auto mark = waiters.insert(waiters.end(), &waiter);
+        if(timed){
+            if(!waiter.ready.wait_until(lock, deadline, [&waiter]() { return waiter.done; })){
+                waiters.erase(mark);
+                --queued;
+                return {};
+            }
         } else{
-            mark->starter_address += t_size;
-            mark->size -= (t_size);
+            waiter.ready.wait(lock, [&waiter]() { return waiter.done; });
         }
+        --queued;
+        return waiter.result;
+    }
 
-        Unit pos(strt, t_size);
 
-        not_empty.notify_one();
-        return pos;
+
+    Unit Table::allocate_memory(size_t t_size, size_t t_align) noexcept(false) {
+        return wait_memory(t_size, t_align, false, std::chrono::steady_clock::time_point());
+    }
+
+
+
+    Unit Table::try_allocate(size_t t_size, size_t t_align) noexcept(false) {
+        if(t_size == 0)
+            throw std::invalid_argument("attempt to allocate an empty block");
+        if(t_align == 0 || (t_align & (t_align - 1)) || t_align > limit)
+            throw std::invalid_argument("alignment is not a power of two within the limit");
+
+        Unit pos;
+        if(t_size <= magazine_size && (pos = pop_cached(t_size, t_align)).size)
+            return pos;
+        if((pos = take_memory(t_size, t_align)).size || !cached_bytes)
+            return pos;
+
+        std::unique_lock<std::mutex> lock(mtx);
+        reclaim();
+        return take_memory(t_size, t_align);
+    }
+
+
+
+    Unit Table::allocate_for(size_t t_size, std::chrono::microseconds t_wait, size_t t_align) noexcept(false) {
+        return wait_memory(t_size, t_align, true, std::chrono::steady_clock::now() + t_wait);
+    }
+
+
+
+    size_t Table::get_largest_free() const noexcept {
+        return largest_free();
     }
 
 
 
     std::vector<unsigned char> Table::read_bytes(size_t t_strt, size_t t_size) const noexcept(false) {
-        if(t_strt < 0 || t_size <= 0)
+        View bytes = view(t_strt, t_size);
+        return std::vector<unsigned char>(bytes.begin(), bytes.end());
+    }
+
+
+
+    void Table::write(size_t t_strt, size_t t_size, const std::vector<unsigned char>& t_vec) noexcept(false) {
+        if(t_vec.size() < t_size)
+            throw std::invalid_argument("not enough bytes to write");
+        Mutable_view bytes = mutable_view(t_strt, t_size);
+        std::copy(t_vec.begin(), t_vec.begin() + t_size, bytes.begin());
+    }
+
+
+
+    View Table::view(size_t t_strt, size_t t_size) const noexcept(false) {
+        if(t_size == 0)
             throw std::invalid_argument("argument below zero");
-        if(t_strt > max_size || t_size > max_size)
+        if(t_strt > capacity || t_size > capacity - t_strt)
             throw std::invalid_argument("argument above maximum available memory");
-
-        std::vector<unsigned char> answer;
-        for(size_t i = 0; i < t_size; ++i){
-            answer.push_back(*(memory.begin() + t_strt + i));
-        }
-        return answer;
+        return {memory.data() + t_strt, t_size};
     }
 
 
 
-    void Table::write(size_t t_strt, size_t t_size, std::vector<unsigned char> t_vec) noexcept(false) {
-        if(t_size > max_size - t_strt)
+    Mutable_view Table::mutable_view(size_t t_strt, size_t t_size) noexcept(false) {
+        if(t_strt > capacity || t_size > capacity - t_strt)
             throw std::invalid_argument("value too big to write");
-        for(size_t i = t_strt; i < t_strt + t_size; ++i){
-            memory[i] = t_vec[i - t_strt];
+        return {memory.data() + t_strt, t_size};
+    }
+
+
+
+    void Table::fill(Unit t_dst, const std::vector<unsigned char>& t_pattern) noexcept(false) {
+        if(t_pattern.empty())
+            throw std::invalid_argument("empty pattern to fill with");
+        Mutable_view bytes = mutable_view(t_dst.starter_address, t_dst.size);
+        if(std::all_of(t_pattern.begin(), t_pattern.end(),
+                       [&t_pattern](unsigned char c) -> bool { return c == t_pattern.front(); })){
+            std::memset(bytes.data, t_pattern.front(), bytes.size);
+            return;
+        }
+        size_t filled = std::min(t_pattern.size(), bytes.size);
+        std::memcpy(bytes.data, t_pattern.data(), filled);
+        while(filled < bytes.size){  // the pattern is a divisor of the filled part, so it repeats itself
+            size_t part = std::min(filled - filled % t_pattern.size(), bytes.size - filled);
+            std::memcpy(bytes.data + filled, bytes.data, part);
+            filled += part;
         }
     }
 
 
-}
\ No newline at end of file
+
+    void Table::copy(Unit t_src, Unit t_dst) noexcept(false) {
+        if(t_src.starter_address < t_dst.starter_address + t_dst.size &&
+           t_dst.starter_address < t_src.starter_address + t_src.size)
+            throw std::invalid_argument("copied blocks overlap");
+        move(t_src, t_dst);
+    }
+
+
+
+    void Table::move(Unit t_src, Unit t_dst) noexcept(false) {
+        if(t_src.size > t_dst.size)
+            throw std::invalid_argument("the destination is smaller than the source");
+        if(t_src.size == 0)
+            return;
+        View from = view(t_src.starter_address, t_src.size);
+        Mutable_view to = mutable_view(t_dst.starter_address, t_src.size);
+        std::memmove(to.data, from.data, from.size);
+    }
+
+
+}
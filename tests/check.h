@@ -0,0 +1,48 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#ifndef MEMORY_MANAGER_CHECK_H
+#define MEMORY_MANAGER_CHECK_H
+
+#include <cstdlib>
+#include <iostream>
+#include <future>
+#include <thread>
+
+/*!
+ * \brief A macro failing the test when the condition does not hold, whatever the build type.
+ */
+#define CHECK(condition) do{ \
+        if(!(condition)){ \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            std::exit(1); \
+        } \
+    } while(0)
+
+/*!
+ * \brief A macro failing the test unless the statement throws the exception.
+ */
+#define CHECK_THROWS(statement, exception) do{ \
+        bool thrown = false; \
+        try{ statement; } catch(const exception&){ thrown = true; } \
+        CHECK(thrown); \
+    } while(0)
+
+/*!
+ * \brief A function running a task in a thread which stays alive, with its cache, until released.
+ */
+template<typename Task>
+inline std::thread keep_alive(Task task, std::future<void> release) {
+    std::promise<void> done;
+    std::future<void> finished = done.get_future();
+    std::thread worker([task, &done](std::future<void> wait) {
+        task();
+        done.set_value();
+        wait.wait();
+    }, std::move(release));
+    finished.wait();
+    return worker;
+}
+
+#endif //MEMORY_MANAGER_CHECK_H
@@ -0,0 +1,39 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+
+using namespace manager;
+
+
+int main() {
+    {   // a block never spans arenas, so the requests bigger than any arena fail at once
+        Table table(1000, 1000, Index_ID, Big_endian, 4);
+        CHECK_THROWS(table.allocate_for(600, std::chrono::seconds(5)), std::runtime_error);
+        CHECK_THROWS(table.allocate_memory(600), std::runtime_error);
+
+        Unit un = table.allocate_memory(250);
+        CHECK(un.size == 250);
+        CHECK_THROWS(table.allocate_for(600, std::chrono::seconds(5)), std::runtime_error);
+        CHECK_THROWS(table.allocate_memory(600), std::runtime_error);  // instead of waiting forever
+        CHECK(table.try_allocate(600).size == 0);
+        table.mark_free(un.starter_address, un.size);
+        CHECK(table.get_used() == 0);
+    }
+    {   // the last arena may still grow up to the limit
+        Table table(1000, 2000, Index_ID, Big_endian, 4);
+        CHECK_THROWS(table.allocate_memory(1300), std::runtime_error);
+        Unit un = table.allocate_memory(900);
+        CHECK(un.size == 900);
+        CHECK(table.allocate_for(1000, std::chrono::milliseconds(10)).size == 0);  // it fits once freed
+        table.mark_free(un.starter_address, un.size);
+    }
+    {   // without a limit the memory does not grow
+        Table table(1000);
+        CHECK(table.get_limit() == 1000);
+        CHECK_THROWS(table.allocate_memory(1001), std::runtime_error);
+    }
+    return 0;
+}
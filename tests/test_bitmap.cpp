@@ -0,0 +1,102 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+#include <memory>
+#include <random>
+
+using namespace manager;
+
+
+//! \brief The granules of the model, one per 8 bytes as in the bitmap engine.
+static const size_t granule = 8;
+
+
+
+//! \brief A function listing the free runs of the model in the address order.
+static std::vector<Unit> model_runs(const std::vector<bool>& free) {
+    std::vector<Unit> runs;
+    for(size_t i = 0; i < free.size();){
+        if(!free[i]){
+            ++i;
+            continue;
+        }
+        size_t end = i;
+        while(end < free.size() && free[end]){
+            ++end;
+        }
+        runs.emplace_back(i * granule, (end - i) * granule);
+        i = end;
+    }
+    return runs;
+}
+
+
+
+/*!
+ * \brief A function allocating the first free run long enough from the model.
+ * \return the block allocated, empty if there is none
+ */
+static Unit model_allocate(std::vector<bool>& free, size_t t_size, size_t t_align) {
+    size_t need = (t_size + granule - 1) / granule;
+    size_t step = t_align > granule ? t_align / granule : 1;
+    for(auto& run : model_runs(free)){
+        size_t strt = run.starter_address / granule;
+        size_t end = strt + run.size / granule;
+        size_t from = (strt + step - 1) / step * step;
+        if(from < end && end - from >= need){
+            std::fill(free.begin() + from, free.begin() + from + need, false);
+            return {from * granule, t_size};
+        }
+    }
+    return {};
+}
+
+
+
+int main() {
+    {   // the long runs of words all free or all in use are skipped, four words at a time with AVX2
+        std::mt19937 gen(3);
+        const size_t granules = 64 * 64;
+        std::unique_ptr<Allocator> engine(Allocator::generate_Allocator(Bitmap_ID, Unit(0, granules * granule)));
+        std::vector<bool> free(granules, true);
+        std::vector<Unit> used;
+        for(int i = 0; i < 3000; ++i){
+            if(used.empty() || gen() % 2){
+                size_t sz = gen() % 4 ? 8 + gen() % 120 : 512 + gen() % 4096;
+                size_t align = size_t(1) << (gen() % 7);
+                Unit un = engine->allocate(sz, align);
+                Unit expected = model_allocate(free, sz, align);
+                CHECK(un.size == expected.size && un.starter_address == expected.starter_address);
+                if(un.size)
+                    used.push_back(un);
+            } else{
+                size_t k = gen() % used.size();
+                engine->release(used[k]);
+                size_t from = used[k].starter_address / granule;
+                std::fill(free.begin() + from, free.begin() + from + (used[k].size + granule - 1) / granule, true);
+                used[k] = used.back();
+                used.pop_back();
+            }
+            auto blocks = engine->get_free_blocks();
+            auto runs = model_runs(free);
+            CHECK(blocks.size() == runs.size());
+            for(size_t j = 0; j < runs.size(); ++j){
+                CHECK(blocks[j] == runs[j]);
+            }
+        }
+    }
+    {   // a free granule far behind the words in use
+        std::unique_ptr<Allocator> engine(Allocator::generate_Allocator(Bitmap_ID, Unit(0, 64 * 64 * granule)));
+        Unit all = engine->allocate(64 * 64 * granule, 8);
+        CHECK(all.size);
+        engine->release(Unit(0, granule));
+        engine->release(Unit(57 * 64 * granule, 64 * granule));
+        Unit un = engine->allocate(64 * granule, 8);
+        CHECK(un.starter_address == 57 * 64 * granule);
+        CHECK(engine->get_free_blocks().size() == 1 && engine->largest_free() == granule);
+    }
+    return 0;
+}
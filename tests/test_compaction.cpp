@@ -0,0 +1,131 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+#include <atomic>
+
+using namespace manager;
+
+
+/*!
+ * \brief A function filling a Program with Arrays and freeing every other one from another thread.
+ * \return the thread keeping the freed blocks in its cache until released
+ */
+static std::thread fragment(Table& table, Program& prog, std::future<void> release) {
+    for(int i = 0; i < 40; ++i){
+        Entity* ent = prog.request_memory(8, 8, Array_ID, "arr" + std::to_string(i));
+        prog.add_entity(ent);
+        dynamic_cast<Array*>(ent)->set_single_instance(table, 0, i);
+    }
+    return keep_alive([&prog]() {
+        for(size_t i = 0; i < 20; ++i){
+            prog.free_entity(i);  // the entities shift, so this frees every other one
+        }
+    }, std::move(release));
+}
+
+
+
+//! \brief A function checking the Arrays kept their elements after being moved.
+static void check_values(Table& table, const Program& prog) {
+    for(size_t i = 0; i < 20; ++i){
+        auto arr = dynamic_cast<const Array*>(prog.get_entity(i));
+        CHECK(arr->get_single_instance(table, 0) == 2*i + 1);
+    }
+}
+
+
+
+int main() {
+    {   // compact_step fills the holes cached by another thread
+        Table table(4096, 4096);
+        Program prog(&table, 4096, "prog");
+        std::promise<void> release;
+        std::thread worker = fragment(table, prog, release.get_future());
+        CHECK(table.get_cached() == 1280);
+
+        Compaction report = table.compact_step(1 << 16, std::chrono::seconds(1));
+        CHECK(report.bytes_moved == 1280 && report.entities_moved == 20);
+        CHECK(table.get_cached() == 0);
+        check_values(table, prog);
+        release.set_value();
+        worker.join();
+    }
+    {   // and so does compact
+        Table table(4096, 4096);
+        Program prog(&table, 4096, "prog");
+        std::promise<void> release;
+        std::thread worker = fragment(table, prog, release.get_future());
+
+        Compaction report = table.compact();
+        CHECK(report.bytes_moved == 1280 && report.entities_moved == 20);
+        CHECK(table.get_largest_free() == 4096 - 1280);
+        check_values(table, prog);
+        release.set_value();
+        worker.join();
+    }
+    {   // a step stops once its budget is spent and the next one goes on from there
+        Table table(4096, 4096);
+        Program prog(&table, 4096, "prog");
+        std::promise<void> release;
+        std::thread worker = fragment(table, prog, release.get_future());
+        for(int i = 0; i < 20; ++i){
+            Compaction report = table.compact_step(64, std::chrono::seconds(1));
+            CHECK(report.bytes_moved == 64 && report.entities_moved == 1);
+        }
+        CHECK(table.compact_step(64, std::chrono::seconds(1)).bytes_moved == 0);
+        CHECK(table.get_largest_free() == 4096 - 1280);
+        check_values(table, prog);
+        release.set_value();
+        worker.join();
+    }
+    {   // the Programs free their Entities while the Compactor moves them
+        Table table(1 << 16, 1 << 16);
+        Program shared(&table, 1 << 16, "shared");
+        auto counter = dynamic_cast<DivSeg*>(shared.request_memory(1, 8, DivSeg_ID, "counter"));
+        shared.add_entity(counter);
+        Compactor compactor(&table, 1 << 10, std::chrono::microseconds(200), std::chrono::milliseconds(0));
+        compactor.start();
+
+        std::atomic<bool> failed(false);
+        std::vector<std::thread> threads;
+        std::vector<Program*> progs;
+        for(int t = 0; t < 3; ++t){
+            progs.push_back(new Program(&table, 1 << 14, "prog" + std::to_string(t)));
+            threads.emplace_back([&table, &failed, counter](Program* prog) {
+                try{
+                    for(int round = 0; round < 1000; ++round){
+                        for(int i = 0; i < 10; ++i){
+                            prog->add_entity(prog->request_memory(1 + i, 8, Array_ID, "arr"));
+                        }
+                        for(int i = 0; i < 5; ++i){
+                            prog->free_entity(i);  // every other one, the holes to be filled
+                        }
+                        while(prog->memory_used() > 1 << 10){  // far below the limit of entities
+                            prog->free_entity(0);
+                        }
+                        counter->fetch_add(table, 0, 1);
+                    }
+                }
+                catch(const std::exception& ex){
+                    std::cerr << ex.what() << std::endl;
+                    failed = true;
+                }
+            }, progs.back());
+        }
+        for(auto& th : threads){
+            th.join();
+        }
+        compactor.stop();
+        CHECK(!failed);
+        CHECK(counter->get_single_instance(table, 0) == 3000);
+        for(auto prog : progs){
+            delete prog;
+        }
+        table.flush_cache();
+        CHECK(table.get_used() == 8);
+    }
+    return 0;
+}
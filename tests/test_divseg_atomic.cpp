@@ -0,0 +1,112 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+#include <atomic>
+
+using namespace manager;
+
+
+//! \brief The step added to every byte of an element at once, so that a torn read shows unequal bytes.
+static const unsigned long long step = 0x0101010101010101ULL;
+
+
+
+//! \brief A function telling whether all the bytes of an element are equal.
+static bool whole(unsigned long long v) {
+    return v == (v & 0xff)*step;
+}
+
+
+
+/*!
+ * \brief A function reading the elements of a Dividable Segment while other threads update them.
+ * \param optimistic whether the reads skip the lock
+ */
+static void check_reads(bool optimistic) {
+    Table table(4096, 4096);
+    Program prog(&table, 4096, "prog");
+    Entity* ent = prog.request_memory(4, 8, DivSeg_ID, "ds");
+    prog.add_entity(ent);
+    auto ds = dynamic_cast<DivSeg*>(ent);
+    ds->fill(table, 0);
+    ds->set_optimistic_reads(optimistic);
+
+    const int writers = 2, rounds = 50000;
+    std::atomic<bool> bad(false);
+    std::vector<std::thread> threads;
+    for(int i = 0; i < writers; ++i){
+        threads.emplace_back([&]() {
+            for(int r = 0; r < rounds; ++r){
+                ds->fetch_add(table, r % 4, step);  // the bytes never carry, an element stays below writers*step
+                ds->fetch_sub(table, r % 4, step);
+            }
+        });
+    }
+    threads.emplace_back([&]() {
+        unsigned long long range[4];
+        for(int r = 0; r < rounds; ++r){
+            unsigned long long v = ds->get_single_instance(table, r % 4);
+            if(!whole(v) || v > writers*step)
+                bad = true;
+            ds->read_range(table, 0, 4, range);
+            for(auto e : range){
+                if(!whole(e))
+                    bad = true;
+            }
+        }
+    });
+    for(auto& th : threads){
+        th.join();
+    }
+    CHECK(!bad);
+    for(auto v : (*ds)(table, 0, 3)){
+        CHECK(v == 0);  // no update is lost
+    }
+}
+
+
+
+//! \brief A function checking the range reads see the updates of a thread in the order it made them.
+static void check_snapshots() {
+    Table table(4096, 4096);
+    Program prog(&table, 4096, "prog");
+    Entity* ent = prog.request_memory(2, 8, DivSeg_ID, "ds");
+    prog.add_entity(ent);
+    auto ds = dynamic_cast<DivSeg*>(ent);
+    ds->fill(table, 0);
+
+    const int rounds = 100000;
+    std::atomic<bool> bad(false), stop(false);
+    std::thread writer([&]() {
+        for(int r = 0; r < rounds; ++r){
+            ds->fetch_add(table, 0, 1);  // the first element is never behind the second
+            ds->fetch_add(table, 1, 1);
+        }
+        stop = true;
+    });
+    std::thread reader([&]() {
+        unsigned long long range[2];
+        while(!stop){
+            ds->read_range(table, 0, 2, range);
+            if(range[0] < range[1] || range[0] - range[1] > 1)
+                bad = true;
+        }
+    });
+    writer.join();
+    reader.join();
+    CHECK(!bad);
+    auto vec = (*ds)(table, 0, 1);
+    CHECK(vec[0] == rounds && vec[1] == rounds);
+}
+
+
+
+int main() {
+    check_reads(false);
+    check_reads(true);
+    check_snapshots();
+    return 0;
+}
@@ -0,0 +1,44 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+
+using namespace manager;
+
+
+int main() {
+    for(int id = Index_ID; id < A_ERR; ++id){
+        Table table(500, 500, static_cast<Alloc_ID>(id));
+
+        // a block freed by two threads is rejected the second time
+        Unit un = table.allocate_memory(16);
+        std::thread first([&table, un]() { table.mark_free(un.starter_address, un.size); });
+        first.join();
+        CHECK_THROWS(table.mark_free(un.starter_address, un.size), std::invalid_argument);
+
+        // and so is a block cached by the freeing thread itself
+        Unit kept = table.allocate_memory(16);
+        table.mark_free(kept.starter_address, kept.size);
+        CHECK_THROWS(table.mark_free(kept.starter_address, kept.size), std::invalid_argument);
+
+        // memory never allocated cannot be freed, nor handed out twice
+        Unit live = table.allocate_memory(10);
+        size_t used = table.get_used();
+        size_t stray = live.starter_address == 200 ? 300 : 200;
+        CHECK_THROWS(table.mark_free(stray, 10), std::invalid_argument);
+        CHECK(table.get_used() == used);
+
+        // a block is freed with the size it was allocated with
+        Unit big = table.allocate_memory(100);
+        CHECK_THROWS(table.mark_free(big.starter_address, 50), std::invalid_argument);
+        table.mark_free(big.starter_address, big.size);
+        CHECK_THROWS(table.mark_free(big.starter_address, big.size), std::invalid_argument);
+
+        table.mark_free(live.starter_address, live.size);
+        CHECK(table.get_used() == 0);
+        table.flush_cache();
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+#include <memory>
+#include <random>
+
+using namespace manager;
+
+
+//! \brief A function measuring the largest free block from the list of them.
+static size_t scan_largest(const Allocator& engine) {
+    size_t largest = 0;
+    for(auto& block : engine.get_free_blocks()){
+        largest = std::max(largest, block.size);
+    }
+    return largest;
+}
+
+
+
+/*!
+ * \brief A function checking the largest free block an engine keeps track of against a scan of its blocks.
+ * \param a_id the engine to be checked
+ */
+static void check_engine(Alloc_ID a_id) {
+    std::mt19937 gen(42);
+    std::unique_ptr<Allocator> engine(Allocator::generate_Allocator(a_id, Unit(0, 1 << 14)));
+    std::vector<Unit> used;
+    for(int i = 0; i < 4000; ++i){
+        if(used.empty() || gen() % 3){
+            Unit un = engine->allocate(8 + gen() % 200, size_t(1) << (gen() % 4));
+            if(un.size)
+                used.push_back(un);
+        } else{
+            size_t k = gen() % used.size();
+            engine->release(used[k]);
+            used[k] = used.back();
+            used.pop_back();
+        }
+        CHECK(engine->largest_free() == scan_largest(*engine));
+        if(i == 2000)  // the memory grows midway
+            engine->extend(Unit(1 << 14, 1 << 14));
+    }
+    for(auto& un : used){
+        engine->release(un);
+    }
+    CHECK(engine->largest_free() == scan_largest(*engine));
+    engine->clear();
+    CHECK(engine->largest_free() == 0);
+}
+
+
+
+/*!
+ * \brief A function checking the biggest free block of a Table follows its arenas and serves the waiters.
+ * \param a_id the engine of the arenas
+ */
+static void check_table(Alloc_ID a_id) {
+    Table table(4096, 4096, a_id, Big_endian, 4);
+    std::vector<Unit> blocks;
+    for(int i = 0; i < 4; ++i){
+        blocks.push_back(table.allocate_memory(1024));
+    }
+    CHECK(table.get_largest_free() == 0);
+    table.mark_free(blocks[1].starter_address, blocks[1].size);
+    CHECK(table.get_largest_free() == 1024);
+    blocks[1] = table.allocate_memory(512);
+    CHECK(table.get_largest_free() == 512);
+
+    std::thread waiter([&table]() {
+        Unit un = table.allocate_for(1024, std::chrono::seconds(5));
+        CHECK(un.size == 1024);
+        table.mark_free(un.starter_address, un.size);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));  // the waiter is asleep by then, most likely
+    table.mark_free(blocks[2].starter_address, blocks[2].size);
+    waiter.join();
+    CHECK(table.get_largest_free() == 1024);
+    for(size_t i : {0, 1, 3}){
+        table.mark_free(blocks[i].starter_address, blocks[i].size);
+    }
+    CHECK(table.get_largest_free() == 1024 && table.get_free() == 4096);
+}
+
+
+
+int main() {
+    for(int a_id = Index_ID; a_id < A_ERR; ++a_id){
+        check_engine(static_cast<Alloc_ID>(a_id));
+        check_table(static_cast<Alloc_ID>(a_id));
+    }
+    {   // the bitmap grown in front of its words
+        std::unique_ptr<Allocator> engine(Allocator::generate_Allocator(Bitmap_ID, Unit(4096, 4096)));
+        Unit un = engine->allocate(64, 8);
+        engine->extend(Unit(0, 4096));
+        CHECK(engine->largest_free() == scan_largest(*engine) && engine->largest_free() == 4096);
+        engine->release(un);
+        CHECK(engine->largest_free() == 8192);
+    }
+    return 0;
+}
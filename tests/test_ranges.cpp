@@ -0,0 +1,60 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+#include <random>
+
+using namespace manager;
+
+
+/*!
+ * \brief A function checking the ranges of elements read and written at once match the single elements.
+ * \param order the order the elements are stored in
+ * \note The widths of 2, 4 and 8 bytes are shuffled 16 bytes at a time when SSSE3 is enabled,
+ * the single elements are always decoded one byte at a time.
+ */
+static void check_order(Byte_order order) {
+    std::mt19937_64 gen(7);
+    Table table(1 << 16, 1 << 16, Index_ID, order);
+    Program prog(&table, 1 << 16, "prog");
+    const size_t count = 37;  // the elements left after the last 16 bytes go one by one
+    for(size_t size = 1; size <= 8; ++size){
+        auto arr = dynamic_cast<Array*>(prog.request_memory(count, size, Array_ID, "arr" + std::to_string(size)));
+        prog.add_entity(arr);
+        unsigned long long mask = size < 8 ? (1ULL << (size*8)) - 1 : ~0ULL;
+
+        unsigned long long in[count], out[count];
+        for(auto& v : in){
+            v = gen() & mask;
+        }
+        arr->write_range(table, 0, in, count);
+        for(size_t i = 0; i < count; ++i){
+            CHECK(arr->get_single_instance(table, i) == in[i]);
+        }
+        View first = table.view(arr->get_pos().starter_address, size);
+        for(size_t b = 0; order == Big_endian && b < size; ++b){  // the portable layout, byte by byte
+            CHECK(first.data[b] == ((in[0] >> ((size - 1 - b)*8)) & 0xff));
+        }
+
+        for(size_t i = 0; i < count; ++i){
+            in[i] = gen() & mask;
+            arr->set_single_instance(table, i, in[i]);
+        }
+        for(size_t from = 0; from < 4; ++from){  // the runs starting inside 16 bytes as well
+            arr->read_range(table, from, count - from, out);
+            for(size_t i = 0; i < count - from; ++i){
+                CHECK(out[i] == in[from + i]);
+            }
+        }
+    }
+}
+
+
+
+int main() {
+    check_order(Big_endian);
+    check_order(Native_order);
+    return 0;
+}
@@ -0,0 +1,62 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+#include <memory>
+
+using namespace manager;
+
+
+/*!
+ * \brief A function checking an engine rejects the blocks overlapping its free memory.
+ * \param a_id the engine to be checked
+ */
+static void check_overlaps(Alloc_ID a_id) {
+    std::unique_ptr<Allocator> engine(Allocator::generate_Allocator(a_id, Unit(0, 1024)));
+    Unit used = engine->allocate(256, 8);
+    CHECK(used.size == 256);
+    Unit hole = engine->get_free_blocks().front();
+    size_t before = engine->free_size();
+
+    if(hole.starter_address >= 8)  // over the start of a free block
+        CHECK_THROWS(engine->release(Unit(hole.starter_address - 8, 16)), std::invalid_argument);
+    if(hole.starter_address + hole.size < 1024)  // over its end
+        CHECK_THROWS(engine->release(Unit(hole.starter_address + hole.size - 8, 16)), std::invalid_argument);
+    CHECK_THROWS(engine->release(Unit(hole.starter_address + 8, 16)), std::invalid_argument);  // inside
+    CHECK_THROWS(engine->release(Unit(hole.starter_address, hole.size)), std::invalid_argument);  // the same
+    CHECK(engine->free_size() == before);
+
+    engine->release(used);
+    CHECK(engine->free_size() == 1024 && engine->largest_free() == 1024);
+}
+
+
+
+//! \brief A function checking the buddy engine rejects the aligned blocks inside or around its free blocks.
+static void check_buddies() {
+    std::unique_ptr<Allocator> engine(Allocator::generate_Allocator(Buddy_ID, Unit(0, 1024)));
+    Unit used = engine->allocate(64, 8);  // the blocks of 64 at 64, 128 at 128, 256 at 256 and 512 at 512 stay free
+    CHECK(used.starter_address == 0);
+
+    CHECK_THROWS(engine->release(Unit(512 + 128, 128)), std::invalid_argument);  // inside a free block
+    CHECK_THROWS(engine->release(Unit(256 + 16, 16)), std::invalid_argument);
+    CHECK_THROWS(engine->release(Unit(0, 128)), std::invalid_argument);  // holding a free block
+    CHECK_THROWS(engine->release(Unit(0, 1024)), std::invalid_argument);
+    CHECK(engine->free_size() == 1024 - 64);
+
+    engine->release(used);
+    CHECK(engine->free_size() == 1024 && engine->largest_free() == 1024);
+}
+
+
+
+int main() {
+    check_overlaps(Index_ID);
+    check_overlaps(Segregated_ID);
+    check_overlaps(Bitmap_ID);
+    check_overlaps(Buddy_ID);
+    check_buddies();
+    return 0;
+}
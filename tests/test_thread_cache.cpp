@@ -0,0 +1,69 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#include "manager.h"
+#include "check.h"
+
+using namespace manager;
+
+
+int main() {
+    {   // the blocks cached by another thread are reclaimed before an allocation fails
+        Table table(500, 500);
+        std::promise<void> release;
+        std::thread worker = keep_alive([&table]() {
+            Unit un = table.allocate_memory(40);
+            table.mark_free(un.starter_address, un.size);
+        }, release.get_future());
+        CHECK(table.get_cached() == 40);
+
+        Unit all = table.allocate_memory(500);
+        CHECK(all.size == 500 && table.get_cached() == 0);
+        table.mark_free(all.starter_address, all.size);
+        table.flush_cache();
+        release.set_value();
+        worker.join();
+    }
+    {   // the same holds for try_allocate
+        Table table(500, 500);
+        std::promise<void> release;
+        std::thread worker = keep_alive([&table]() {
+            Unit un = table.allocate_memory(40);
+            table.mark_free(un.starter_address, un.size);
+        }, release.get_future());
+        CHECK(table.try_allocate(500).size == 500);
+        release.set_value();
+        worker.join();
+    }
+    {   // a thread keeps a bounded amount of memory
+        Table table(1 << 16, 1 << 16);
+        std::vector<Unit> blocks;
+        for(size_t sz = 40; sz <= 64; ++sz){
+            for(int i = 0; i < 20; ++i){
+                blocks.push_back(table.allocate_memory(sz));
+            }
+        }
+        for(auto& un : blocks){
+            table.mark_free(un.starter_address, un.size);
+        }
+        CHECK(table.get_cached() <= 4096);
+        CHECK(table.get_free() + table.get_cached() == table.get_capacity());
+    }
+    {   // a waiter takes the blocks cached by the other threads instead of sleeping
+        Table table(100, 100);
+        Unit rest = table.allocate_memory(60);
+        std::promise<void> release;
+        std::thread worker = keep_alive([&table]() {
+            Unit un = table.allocate_memory(40);
+            table.mark_free(un.starter_address, un.size);
+        }, release.get_future());
+        Unit un = table.allocate_for(40, std::chrono::microseconds(1000));
+        CHECK(un.size == 40);
+        table.mark_free(un.starter_address, un.size);
+        table.mark_free(rest.starter_address, rest.size);
+        release.set_value();
+        worker.join();
+    }
+    return 0;
+}